@@ -0,0 +1,393 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <numeric>
+
+#include <box2d/box2d.h>
+#include <SDL_gpu.h>
+
+#include "..\Neural.hpp"
+#include "..\Fuzzy.hpp"
+#include "..\Replay.hpp"
+#include "..\Raster.hpp"
+#include "..\Network.hpp"
+#include "..\Fixture.hpp"
+#include "..\Simulation\Maze.hpp"
+#include "..\Simulation\Car.hpp"
+#include "..\Simulation\Episode.hpp"
+#include "..\Simulation\Evolution.hpp"
+#include "..\Simulation\Window.hpp"
+
+// Times each case in batches of at least 'minimumBatch' so clock resolution does not matter, reporting per call
+class Benchmark
+{
+public:
+    struct Result
+    {
+        std::string name;
+        int batch;
+        int samples;
+        double median;
+        double p99;
+        double mean;
+        double minimum;
+    };
+
+    Benchmark(const std::string& filter)
+    {
+        this->filter = filter;
+    }
+
+    auto run(const std::string& name, const std::function<void()>& body) -> void
+    {
+        if (not this->filter.empty() and name.find(this->filter) == std::string::npos)
+        {
+            return;
+        }
+
+        using Clock = std::chrono::steady_clock;
+
+        // Warm up, then grow the batch until one sample takes long enough
+        auto batch{ 1 };
+        while (true)
+        {
+            const auto start{ Clock::now() };
+            for (auto n{ 0 }; n < batch; ++n)
+            {
+                body();
+            }
+            const auto elapsed{ Clock::now() - start };
+            if (elapsed >= Benchmark::minimumBatch or batch >= (1 << 20))
+            {
+                break;
+            }
+            batch *= 2;
+        }
+
+        auto times{ std::vector<double>{} };
+        times.reserve(Benchmark::samples);
+        for (auto s{ 0 }; s < Benchmark::samples; ++s)
+        {
+            const auto start{ Clock::now() };
+            for (auto n{ 0 }; n < batch; ++n)
+            {
+                body();
+            }
+            const auto elapsed{ std::chrono::duration<double, std::nano>{ Clock::now() - start } };
+            times.emplace_back(elapsed.count() / batch);
+        }
+        std::sort(times.begin(), times.end());
+
+        auto result{ Result{} };
+        result.name = name;
+        result.batch = batch;
+        result.samples = Benchmark::samples;
+        result.median = times[times.size() / 2];
+        result.p99 = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+        result.mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        result.minimum = times.front();
+
+        std::cout << std::left << std::setw(40) << result.name << std::right
+            << " median " << std::setw(12) << std::fixed << std::setprecision(1) << result.median << " ns"
+            << " | p99 " << std::setw(12) << result.p99 << " ns"
+            << " | batch " << result.batch << std::endl;
+
+        this->results.emplace_back(result);
+    }
+
+    auto save(const std::string& filePath) const -> void
+    {
+        auto ofs{ std::ofstream{ filePath } };
+        ofs << std::fixed << std::setprecision(1);
+        ofs << "{\n  \"unit\": \"ns\",\n  \"results\": [";
+        for (auto n{ 0 }; n < this->results.size(); ++n)
+        {
+            const auto& result{ this->results[n] };
+            ofs << (n > 0 ? "," : "") << "\n    {"
+                << "\"name\": \"" << result.name << "\", "
+                << "\"batch\": " << result.batch << ", "
+                << "\"samples\": " << result.samples << ", "
+                << "\"median\": " << result.median << ", "
+                << "\"p99\": " << result.p99 << ", "
+                << "\"mean\": " << result.mean << ", "
+                << "\"min\": " << result.minimum << "}";
+        }
+        ofs << "\n  ]\n}\n";
+    }
+
+    static constexpr int samples{ 101 };
+    static constexpr std::chrono::microseconds minimumBatch{ 2000 };
+
+private:
+    std::string filter{};
+    std::vector<Result> results{};
+};
+
+// Cars parked at the start of their own maze, laid out on a grid of a single world
+struct Fleet
+{
+    Fleet(int quantity)
+    {
+        b2BodyDef bd{};
+        bd.userData = Fixture::tag(Fixture::Kind::GROUND);
+        this->ground = this->world.CreateBody(&bd);
+
+        this->mazes.reserve(quantity);
+        this->cars.reserve(quantity);
+        for (auto n{ 0 }; n < quantity; ++n)
+        {
+            auto& maze{ this->mazes.emplace_back(&world, ground, 3, 3, (n % 32) * 1.7f, (n / 32) * 1.7f, 1.5f, 1.5f) };
+            maze.randomize();
+            this->cars.emplace_back(&world, ground, maze.startPoint());
+        }
+    }
+
+    b2World world{ b2Vec2{ 0.0f, 0.0f } };
+    b2Body* ground{ nullptr };
+    std::vector<Maze> mazes{};
+    std::vector<Car> cars{};
+};
+
+int main(int argc, char* args[])
+{
+    const auto rootPath{ std::filesystem::path{ R"(C:\Users\Giovanni\Desktop\auto2)" } };
+    const auto outputPath{ argc > 1 ? std::string{ args[1] } : (rootPath / "scripts" / "benchmark.json").string() };
+    const auto filter{ argc > 2 ? std::string{ args[2] } : std::string{} };
+
+    auto benchmark{ Benchmark{ filter } };
+    auto mt{ std::mt19937{ 42 } };
+    auto dist{ std::uniform_real_distribution{ 0.0f, 2.0f } };
+
+    auto inputs{ std::vector<float>(18) };
+    std::generate(inputs.begin(), inputs.end(), [&] { return dist(mt); });
+
+    // Sensors, Car::stepSensor through Car::sense, 18 beams per car
+    for (const auto quantity : { 1, 100, 1000 })
+    {
+        auto fleet{ Fleet{ quantity } };
+        benchmark.run("car.sense/" + std::to_string(quantity), [&]
+            {
+                for (auto& car : fleet.cars)
+                {
+                    car.sense();
+                }
+            });
+    }
+
+    // Maze generation and solving
+    for (const auto size : { 3, 8, 16, 32, 64, 256, 1024 })
+    {
+        benchmark.run("maze.make/" + std::to_string(size), [&]
+            {
+                const auto matrix{ Maze::make(size, size) };
+            });
+
+        const auto matrix{ Maze::make(size, size) };
+        benchmark.run("maze.solve/" + std::to_string(size), [&]
+            {
+                const auto path{ Maze::solve(matrix, size - 1, size - 1, true) };
+            });
+        benchmark.run("maze.explore/" + std::to_string(size), [&]
+            {
+                const auto path{ Maze::solve(matrix, size - 1, size - 1, false) };
+            });
+        benchmark.run("maze.field/" + std::to_string(size), [&]
+            {
+                const auto field{ Maze::field(matrix) };
+            });
+
+        // What a reset pays once the field is cached with the maze
+        const auto field{ Maze::field(matrix) };
+        benchmark.run("maze.descend/" + std::to_string(size), [&]
+            {
+                const auto path{ Maze::descend(matrix, field, size - 1, size - 1) };
+            });
+    }
+
+    // Every generator on the same sizes, backtracker aside
+    for (const auto& generator : { std::pair{ "eller", Maze::Generator::ELLER }, std::pair{ "kruskal", Maze::Generator::KRUSKAL }, std::pair{ "wilson", Maze::Generator::WILSON }, std::pair{ "braid", Maze::Generator::BRAID } })
+    {
+        for (const auto size : { 8, 64, 1024 })
+        {
+            benchmark.run(std::string{ "maze.make/" } + generator.first + "/" + std::to_string(size), [&]
+                {
+                    const auto matrix{ Maze::make(size, size, std::nullopt, generator.second) };
+                });
+        }
+    }
+
+    // Rebuilding the walls of a generated maze, and sensing inside one
+    for (const auto size : { 8, 32, 64 })
+    {
+        auto world{ b2World{ b2Vec2{ 0.0f, 0.0f } } };
+        b2BodyDef bd{};
+        const auto ground{ world.CreateBody(&bd) };
+
+        auto maze{ Maze{ &world, ground, static_cast<size_t>(size), static_cast<size_t>(size), 0.0f, 0.0f, size * 0.5f, size * 0.5f, Maze::Layout::GENERATED } };
+        benchmark.run("maze.randomize/" + std::to_string(size), [&]
+            {
+                maze.randomize();
+            });
+
+        auto car{ Car{ &world, ground, maze.startPoint() } };
+        benchmark.run("maze.sense/" + std::to_string(size), [&]
+            {
+                car.sense();
+            });
+    }
+
+    // Every model in scripts/models, native networks and SavedModels alike
+    const auto modelsPath{ rootPath / "scripts" / "models" };
+    if (std::filesystem::is_directory(modelsPath))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator{ modelsPath })
+        {
+            const auto neural{ Neural{ entry.path().string() } };
+            benchmark.run("neural.inference/" + entry.path().filename().string(), [&]
+                {
+                    const auto outputs{ neural.inference(inputs) };
+                });
+        }
+    }
+
+    {
+        const auto network{ Network{ { 18, 48, 48, 48, 5 }, mt } };
+        benchmark.run("network.inference/18x48x48x48x5", [&]
+            {
+                const auto outputs{ network.inference(inputs) };
+            });
+    }
+
+    if (std::filesystem::exists(rootPath / "fuzzy.fll"))
+    {
+        const auto fuzzy{ Fuzzy{ (rootPath / "fuzzy.fll").string() } };
+        benchmark.run("fuzzy.inference", [&]
+            {
+                const auto outputs{ fuzzy.inference(inputs) };
+            });
+    }
+
+    // Replay::stepFile through Replay::step, restarting the capture when it runs out
+    const auto captures{ Replay::captures((rootPath / "scripts").string()) };
+    if (not captures.empty())
+    {
+        auto world{ b2World{ b2Vec2{ 0.0f, 0.0f } } };
+        b2BodyDef bd{};
+        const auto ground{ world.CreateBody(&bd) };
+
+        auto replay{ std::make_unique<Replay>(&world, ground, b2Vec2{ 0.0f, 0.0f }, captures.front()) };
+        benchmark.run("replay.step", [&]
+            {
+                if (replay->isDone())
+                {
+                    replay = std::make_unique<Replay>(&world, ground, b2Vec2{ 0.0f, 0.0f }, captures.front());
+                }
+                replay->step();
+            });
+    }
+
+    // Drawing, on the GPU when a context can be created and always through the software rasteriser
+    {
+        auto fleet{ Fleet{ 100 } };
+
+        auto snapshot{ Snapshot{} };
+        snapshot.statics.resize(fleet.mazes.size());
+        snapshot.bodies.resize(fleet.cars.size());
+        for (auto n{ 0 }; n < fleet.cars.size(); ++n)
+        {
+            fleet.cars[n].sense();
+            fleet.mazes[n].snapshot(snapshot.statics[n]);
+            snapshot.bodies[n].bounds = fleet.mazes[n].bounds();
+            fleet.cars[n].snapshot(snapshot.bodies[n]);
+        }
+
+        auto list{ Draw::Mesh{} };
+        benchmark.run("draw.append/100", [&]
+            {
+                Draw::clear(list);
+                for (const auto& body : snapshot.bodies)
+                {
+                    Draw::append(list, *body.shape, body.transform);
+                    for (const auto& [start, end] : body.beams)
+                    {
+                        Draw::append(list, start, end, Snapshot::beamColor);
+                    }
+                }
+            });
+
+        auto raster{ Raster{ 1000, 1000 } };
+        auto bounds{ b2AABB{} };
+        bounds.lowerBound = b2Vec2{ 0.0f, 0.0f };
+        bounds.upperBound = b2Vec2{ 17.0f, 17.0f };
+        raster.view(bounds);
+        benchmark.run("raster.draw/100", [&]
+            {
+                raster.clear(Window::backgroundColor);
+                raster.draw(snapshot);
+            });
+
+        const auto target{ GPU_Init(1000, 1000, SDL_WINDOW_HIDDEN) };
+        if (target != nullptr)
+        {
+            GPU_SetLineThickness(0.01f);
+            GPU_MatrixMode(target, GPU_PROJECTION);
+            GPU_LoadIdentity();
+            GPU_Ortho(bounds.lowerBound.x, bounds.upperBound.x, bounds.upperBound.y, bounds.lowerBound.y, 0, 1);
+
+            benchmark.run("draw.draw/100", [&]
+                {
+                    Draw::draw(target, list);
+                    for (const auto& item : snapshot.statics)
+                    {
+                        Draw::draw(target, *item.mesh);
+                    }
+                    GPU_FlushBlitBuffer();
+                });
+
+            GPU_Quit();
+        }
+    }
+
+    // A full headless tick: decide, drive, step the world and sense, for a fleet of episodes
+    {
+        const auto network{ Network{ { 18, 48, 48, 48, 5 }, mt } };
+
+        for (const auto& dynamics : { std::pair{ "dynamic", Car::Dynamics::DYNAMIC }, std::pair{ "direct", Car::Dynamics::DIRECT }, std::pair{ "kinematic", Car::Dynamics::KINEMATIC } })
+        {
+            for (const auto quality : { &Quality::precise, &Quality::standard, &Quality::fast })
+            {
+                auto episodes{ std::vector<std::unique_ptr<Episode>>{} };
+                for (auto n{ 0 }; n < 64; ++n)
+                {
+                    episodes.emplace_back(std::make_unique<Episode>(nullptr, n, dynamics.second, *quality, Maze::Layout::GENERATED));
+                }
+
+                benchmark.run(std::string{ "episode.tick/64/" } + dynamics.first + "/" + quality->name, [&]
+                    {
+                        for (auto& episode : episodes)
+                        {
+                            if (episode->isDone() or episode->ticks() >= Evolution::ticks)
+                            {
+                                episode->reset();
+                            }
+                            episode->step(Car::decide(network.inference(episode->inputs())));
+                        }
+                    });
+            }
+        }
+    }
+
+    benchmark.save(outputPath);
+    std::cout << "results = " << outputPath << std::endl;
+
+    return EXIT_SUCCESS;
+}
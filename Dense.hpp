@@ -0,0 +1,55 @@
+#pragma once
+
+#include <immintrin.h>
+
+// AVX kernels for the dense layers of Network and Trainer, with scalar tails for sizes that are not multiples of 8
+namespace Dense
+{
+    // Returns sum(a[i] * b[i])
+    static auto dot(const float* a, const float* b, int n) -> float
+    {
+        auto i{ 0 };
+        auto sum{ _mm256_setzero_ps() };
+        for (; i + 8 <= n; i += 8)
+        {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+
+        const auto low{ _mm256_castps256_ps128(sum) };
+        const auto high{ _mm256_extractf128_ps(sum, 1) };
+        auto quad{ _mm_add_ps(low, high) };
+        quad = _mm_hadd_ps(quad, quad);
+        quad = _mm_hadd_ps(quad, quad);
+
+        auto result{ _mm_cvtss_f32(quad) };
+        for (; i < n; ++i)
+        {
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+
+    // Computes y[i] += alpha * x[i]
+    static auto axpy(float alpha, const float* x, float* y, int n) -> void
+    {
+        auto i{ 0 };
+        const auto a{ _mm256_set1_ps(alpha) };
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(a, _mm256_loadu_ps(x + i))));
+        }
+        for (; i < n; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    // Computes output = weights * input + biases, weights being outputs x inputs and row-major
+    static auto forward(const float* weights, const float* biases, const float* input, float* output, int inputs, int outputs) -> void
+    {
+        for (auto o{ 0 }; o < outputs; ++o)
+        {
+            output[o] = biases[o] + Dense::dot(weights + o * inputs, input, inputs);
+        }
+    }
+}
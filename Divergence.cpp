@@ -0,0 +1,188 @@
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+
+#include <box2d/box2d.h>
+
+#include "Divergence.hpp"
+#include "Replay.hpp"
+#include "Fixture.hpp"
+#include "Simulation\Window.hpp"
+
+auto Divergence::Statistics::add(double residual) -> void
+{
+    ++this->count;
+
+    const auto delta{ residual - this->mean };
+    this->mean += delta / this->count;
+    this->m2 += delta * (residual - this->mean);
+    this->squares += residual * residual;
+    this->maximum = std::max(this->maximum, std::abs(residual));
+}
+
+auto Divergence::Statistics::merge(const Statistics& other) -> void
+{
+    this->misses += other.misses;
+
+    if (other.count == 0)
+    {
+        return;
+    }
+
+    const auto count{ this->count + other.count };
+    const auto delta{ other.mean - this->mean };
+
+    this->m2 += other.m2 + delta * delta * this->count * other.count / count;
+    this->mean += delta * other.count / count;
+    this->squares += other.squares;
+    this->maximum = std::max(this->maximum, other.maximum);
+    this->count = count;
+}
+
+auto Divergence::Statistics::deviation() const -> double
+{
+    return this->count > 1 ? std::sqrt(this->m2 / (this->count - 1)) : 0.0;
+}
+
+auto Divergence::Statistics::rmse() const -> double
+{
+    return this->count > 0 ? std::sqrt(this->squares / this->count) : 0.0;
+}
+
+auto Divergence::analyze(const std::string& filePath, bool joint) -> Report
+{
+    auto report{ Report{} };
+    report.filePath = filePath;
+
+    // Each capture runs on its own world, so captures can be analyzed concurrently
+    auto world{ b2World{ b2Vec2{ 0.0f, 0.0f } } };
+
+    b2BodyDef bd{};
+    bd.userData = Fixture::tag(Fixture::Kind::GROUND);
+    const auto ground{ world.CreateBody(&bd) };
+
+    {
+        auto replay{ Replay{ &world, ground, b2Vec2{ 0.0f, 0.0f }, filePath, joint } };
+        report.angles = replay.angles();
+
+        const auto record{ [&]
+        {
+            auto& frame{ report.frames.emplace_back(Frame{ replay.line(), replay.recorded(), replay.simulated() }) };
+            for (auto n{ 0 }; n < frame.recorded.size(); ++n)
+            {
+                if (frame.simulated[n].valid)
+                {
+                    report.statistics[n].add(frame.recorded[n] - frame.simulated[n].distance);
+                }
+                else
+                {
+                    ++report.statistics[n].misses;
+                }
+            }
+        } };
+
+        // The recorded distances of a line were measured before its move was applied
+        record();
+        while (true)
+        {
+            replay.step();
+            if (replay.isDone())
+            {
+                break;
+            }
+            record();
+
+            world.Step(Window::timeStep, 4, 4);
+        }
+    }
+
+    return report;
+}
+
+auto Divergence::analyze(const std::vector<std::string>& filePaths, bool joint) -> std::vector<Report>
+{
+    auto reports{ std::vector<Report>(filePaths.size()) };
+
+#pragma omp parallel for schedule(dynamic)
+    for (auto n{ 0 }; n < filePaths.size(); ++n)
+    {
+        reports[n] = Divergence::analyze(filePaths[n], joint);
+    }
+
+    return reports;
+}
+
+auto Divergence::summarize(const std::vector<Report>& reports) -> std::array<Statistics, 6>
+{
+    auto statistics{ std::array<Statistics, 6>{} };
+    for (const auto& report : reports)
+    {
+        for (auto n{ 0 }; n < statistics.size(); ++n)
+        {
+            statistics[n].merge(report.statistics[n]);
+        }
+    }
+    return statistics;
+}
+
+auto Divergence::save(const std::vector<Report>& reports, const std::string& filePath) -> void
+{
+    auto ofs{ std::ofstream{ filePath } };
+
+    ofs << "file;line;sensor;recorded;simulated;valid;incidence;residual;\n";
+
+    for (const auto& report : reports)
+    {
+        for (const auto& frame : report.frames)
+        {
+            for (auto n{ 0 }; n < frame.recorded.size(); ++n)
+            {
+                const auto& simulated{ frame.simulated[n] };
+
+                ofs << report.filePath << ';'
+                    << frame.line << ';'
+                    << report.angles[n] << ';'
+                    << frame.recorded[n] << ';'
+                    << simulated.distance << ';'
+                    << simulated.valid << ';'
+                    << simulated.incidence << ';'
+                    << frame.recorded[n] - simulated.distance << ";\n";
+            }
+        }
+    }
+}
+
+auto Divergence::print(const std::vector<Report>& reports) -> void
+{
+    const auto print{ [](const std::array<int, 6>& angles, const std::array<Statistics, 6>& statistics)
+    {
+        for (auto n{ 0 }; n < statistics.size(); ++n)
+        {
+            std::cout << std::setw(6) << angles[n]
+                << " | count = " << std::setw(7) << statistics[n].count
+                << " | misses = " << std::setw(5) << statistics[n].misses
+                << " | mean = " << std::setw(9) << statistics[n].mean
+                << " | deviation = " << std::setw(9) << statistics[n].deviation()
+                << " | rmse = " << std::setw(9) << statistics[n].rmse()
+                << " | maximum = " << std::setw(9) << statistics[n].maximum << '\n';
+        }
+    } };
+
+    std::cout << std::fixed << std::setprecision(4);
+
+    for (const auto& report : reports)
+    {
+        std::cout << report.filePath << " (" << report.frames.size() << " frames)" << '\n';
+        print(report.angles, report.statistics);
+    }
+
+    if (not reports.empty())
+    {
+        std::cout << "total" << '\n';
+        print(reports.front().angles, Divergence::summarize(reports));
+    }
+
+    std::cout << std::endl;
+}
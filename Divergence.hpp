@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <array>
+
+#include "Sensor.hpp"
+
+class Divergence
+{
+public:
+    struct Frame
+    {
+        int line;
+        std::array<float, 6> recorded;
+        std::array<Sensor::Reading, 6> simulated;
+    };
+
+    struct Statistics
+    {
+        int count{ 0 };
+        int misses{ 0 };
+        double mean{ 0.0 };
+        double m2{ 0.0 };
+        double squares{ 0.0 };
+        double maximum{ 0.0 };
+
+        auto add(double residual) -> void;
+        auto merge(const Statistics& other) -> void;
+        auto deviation() const -> double;
+        auto rmse() const -> double;
+    };
+
+    struct Report
+    {
+        std::string filePath;
+        std::array<int, 6> angles;
+        std::vector<Frame> frames;
+        std::array<Statistics, 6> statistics;
+    };
+
+    static auto analyze(const std::string& filePath, bool joint = true) -> Report;
+    static auto analyze(const std::vector<std::string>& filePaths, bool joint = true) -> std::vector<Report>;
+    static auto summarize(const std::vector<Report>& reports) -> std::array<Statistics, 6>;
+    static auto save(const std::vector<Report>& reports, const std::string& filePath) -> void;
+    static auto print(const std::vector<Report>& reports) -> void;
+};
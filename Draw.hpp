@@ -2,37 +2,40 @@
 
 #include <vector>
 #include <string>
-#include <map>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 #include <box2d/box2d.h>
 #include <SDL_gpu.h>
 
+#include "Fixture.hpp"
+
 namespace Draw
 {
-    static const std::map<const char*, SDL_Color> colors{
-        {"start",{0,255,0}},
-        {"end",  {255,0,0}},
-        {"wall", {255,0,255}},
-        {"chassis",{255,127,0}},
-        {"sensor", {255,255,0}}
-    };
+    // Outline width in world units, set before every outline batch since SDL_gpu keeps whatever the last caller left
+    static constexpr auto lineThickness{ 0.01f };
+
+    // Unit circle used to tessellate circle fixtures
+    static constexpr auto circleSegments{ 16 };
+    static const auto circle{ []
+    {
+        auto points{ std::array<b2Vec2, circleSegments>{} };
+        for (auto n{ 0 }; n < circleSegments; ++n)
+        {
+            const auto radians{ 2.0f * b2_pi * n / circleSegments };
+            points[n] = b2Vec2{ std::cos(radians), std::sin(radians) };
+        }
+        return points;
+    }() };
 
     static auto draw(GPU_Target* target, const b2Body* body) -> void
     {
         for (auto fixture{ body->GetFixtureList() }; fixture != nullptr; fixture = fixture->GetNext())
         {
-            auto solidBorderColor{ SDL_Color{ 255, 0, 255, 255} };
-            auto solidFillColor{ SDL_Color{ 255, 0, 255, 64} };
-
-            const auto name{ reinterpret_cast<const char*>(fixture->GetUserData()) };
-            const auto it{ colors.find(name) };
-            if (it != colors.end())
-            {
-                solidBorderColor = it->second;
-                solidBorderColor.a = 255;
-
-                solidFillColor = it->second;
-                solidFillColor.a = 64;
-            }
+            const auto& record{ Fixture::record(fixture) };
+            const auto& solidBorderColor{ record.border };
+            const auto& solidFillColor{ record.fill };
 
             //if (strcmp(name, "sensor") == 0 or strcmp(name, "start") == 0 or strcmp(name, "end") == 0) 
             //{
@@ -102,4 +105,243 @@ namespace Draw
             }
         }
     }
+
+    // Geometry uploaded once and submitted with one batched call per primitive type, for bodies that never move
+    struct Batch
+    {
+        std::vector<float> vertices; // x, y, r, g, b, a
+        std::vector<unsigned short> indices;
+    };
+
+    struct Mesh
+    {
+        std::vector<Batch> triangles;
+        std::vector<Batch> lines;
+    };
+
+    static auto append(std::vector<Batch>& batches, const std::vector<b2Vec2>& points, const std::vector<unsigned short>& indices, const SDL_Color& color) -> void
+    {
+        // First batch with room left, batches emptied by clear() are refilled before new ones are made
+        auto it{ std::find_if(batches.begin(), batches.end(), [&](const Batch& batch)
+        {
+            return batch.vertices.size() / 6 + points.size() <= std::numeric_limits<unsigned short>::max();
+        }) };
+        if (it == batches.end())
+        {
+            it = batches.insert(batches.end(), Batch{});
+        }
+
+        auto& batch{ *it };
+        const auto base{ static_cast<unsigned short>(batch.vertices.size() / 6) };
+
+        for (const auto& point : points)
+        {
+            batch.vertices.insert(batch.vertices.end(), { point.x, point.y, color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f });
+        }
+        for (const auto& index : indices)
+        {
+            batch.indices.emplace_back(base + index);
+        }
+    }
+
+    // Appends the fixtures of a body placed at 'transform', outlines only when not 'filled'
+    static auto append(Mesh& mesh, const b2Body* body, const b2Transform& transform, bool filled = true) -> void
+    {
+        // Scratch buffers reused across calls, so appending a body does not allocate once warmed up
+        thread_local auto points{ std::vector<b2Vec2>{} };
+        thread_local auto fill{ std::vector<unsigned short>{} };
+        thread_local auto border{ std::vector<unsigned short>{} };
+
+        // Polygon outline plus triangle fan, both indexed into the same points
+        const auto polygon{ [&](const SDL_Color& borderColor, const SDL_Color& fillColor)
+        {
+            fill.clear();
+            border.clear();
+            for (auto n{ 0 }; n < points.size(); ++n)
+            {
+                border.insert(border.end(), { static_cast<unsigned short>(n), static_cast<unsigned short>((n + 1) % points.size()) });
+            }
+            Draw::append(mesh.lines, points, border, borderColor);
+
+            if (filled)
+            {
+                for (auto n{ 1 }; n + 1 < points.size(); ++n)
+                {
+                    fill.insert(fill.end(), { 0, static_cast<unsigned short>(n), static_cast<unsigned short>(n + 1) });
+                }
+                Draw::append(mesh.triangles, points, fill, fillColor);
+            }
+        } };
+
+        for (auto fixture{ body->GetFixtureList() }; fixture != nullptr; fixture = fixture->GetNext())
+        {
+            const auto& record{ Fixture::record(fixture) };
+            const auto& solidBorderColor{ record.border };
+            const auto& solidFillColor{ record.fill };
+
+            points.clear();
+
+            const auto shape{ fixture->GetShape() };
+            switch (shape->GetType())
+            {
+                case b2Shape::e_circle:
+                {
+                    const auto circle{ reinterpret_cast<const b2CircleShape*>(shape) };
+
+                    for (const auto& unit : Draw::circle)
+                    {
+                        points.emplace_back(b2Mul(transform, circle->m_p + circle->m_radius * unit));
+                    }
+                    polygon(solidBorderColor, solidFillColor);
+
+                    break;
+                }
+                case b2Shape::e_edge:
+                {
+                    const auto edge{ reinterpret_cast<const b2EdgeShape*>(shape) };
+
+                    points.emplace_back(b2Mul(transform, edge->m_vertex1));
+                    points.emplace_back(b2Mul(transform, edge->m_vertex2));
+                    Draw::append(mesh.lines, points, { 0, 1 }, solidBorderColor);
+
+                    break;
+                }
+                case b2Shape::e_polygon:
+                {
+                    const auto polygonShape{ reinterpret_cast<const b2PolygonShape*>(shape) };
+
+                    for (auto n{ 0 }; n < polygonShape->m_count; ++n)
+                    {
+                        points.emplace_back(b2Mul(transform, polygonShape->m_vertices[n]));
+                    }
+                    polygon(solidBorderColor, solidFillColor);
+
+                    break;
+                }
+                case b2Shape::e_chain:
+                {
+                    const auto chain{ reinterpret_cast<const b2ChainShape*>(shape) };
+
+                    border.clear();
+                    for (auto n{ 0 }; n < chain->m_count; ++n)
+                    {
+                        points.emplace_back(b2Mul(transform, chain->m_vertices[n]));
+                        if (n > 0)
+                        {
+                            border.insert(border.end(), { static_cast<unsigned short>(n - 1), static_cast<unsigned short>(n) });
+                        }
+                    }
+                    Draw::append(mesh.lines, points, border, solidBorderColor);
+
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    static auto append(Mesh& mesh, const b2Body* body, bool filled = true) -> void
+    {
+        Draw::append(mesh, body, body->GetTransform(), filled);
+    }
+
+    // Appends a mesh built in body coordinates, placed at 'transform'
+    static auto append(Mesh& mesh, const Mesh& shape, const b2Transform& transform, bool filled = true) -> void
+    {
+        const auto place{ [&](std::vector<Batch>& batches, const std::vector<Batch>& source)
+        {
+            for (const auto& from : source)
+            {
+                const auto count{ from.vertices.size() / 6 };
+                auto it{ std::find_if(batches.begin(), batches.end(), [&](const Batch& batch)
+                {
+                    return batch.vertices.size() / 6 + count <= std::numeric_limits<unsigned short>::max();
+                }) };
+                if (it == batches.end())
+                {
+                    it = batches.insert(batches.end(), Batch{});
+                }
+
+                auto& batch{ *it };
+                const auto base{ static_cast<unsigned short>(batch.vertices.size() / 6) };
+
+                for (auto n{ 0 }; n < count; ++n)
+                {
+                    const auto* vertex{ &from.vertices[n * 6] };
+                    const auto point{ b2Mul(transform, b2Vec2{ vertex[0], vertex[1] }) };
+                    batch.vertices.insert(batch.vertices.end(), { point.x, point.y, vertex[2], vertex[3], vertex[4], vertex[5] });
+                }
+                for (const auto& index : from.indices)
+                {
+                    batch.indices.emplace_back(base + index);
+                }
+            }
+        } };
+
+        place(mesh.lines, shape.lines);
+        if (filled)
+        {
+            place(mesh.triangles, shape.triangles);
+        }
+    }
+
+    static auto append(Mesh& mesh, const b2Vec2& start, const b2Vec2& end, const SDL_Color& color) -> void
+    {
+        Draw::append(mesh.lines, { start, end }, { 0, 1 }, color);
+    }
+
+    static auto build(const b2Body* body) -> Mesh
+    {
+        auto mesh{ Mesh{} };
+        Draw::append(mesh, body);
+        return mesh;
+    }
+
+    // Same as build(), but in body coordinates, to be placed later with append(mesh, shape, transform)
+    static auto shape(const b2Body* body) -> Mesh
+    {
+        auto mesh{ Mesh{} };
+        Draw::append(mesh, body, b2Transform{ b2Vec2_zero, b2Rot{ 0.0f } });
+        return mesh;
+    }
+
+    // Empties a per-frame draw list, keeping its allocations
+    static auto clear(Mesh& mesh) -> void
+    {
+        for (auto& batch : mesh.triangles)
+        {
+            batch.vertices.clear();
+            batch.indices.clear();
+        }
+        for (auto& batch : mesh.lines)
+        {
+            batch.vertices.clear();
+            batch.indices.clear();
+        }
+    }
+
+    // SDL_gpu takes non-const arrays but only reads them, so shared meshes can be drawn from any snapshot
+    static auto draw(GPU_Target* target, const Mesh& mesh, bool filled = true) -> void
+    {
+        GPU_SetLineThickness(Draw::lineThickness);
+        for (auto& batch : mesh.triangles)
+        {
+            if (not filled or batch.indices.empty())
+            {
+                continue;
+            }
+            GPU_PrimitiveBatch(nullptr, target, GPU_TRIANGLES, batch.vertices.size() / 6, const_cast<float*>(batch.vertices.data()), batch.indices.size(), const_cast<unsigned short*>(batch.indices.data()), GPU_BATCH_XY_RGBA);
+        }
+        for (auto& batch : mesh.lines)
+        {
+            if (batch.indices.empty())
+            {
+                continue;
+            }
+            GPU_PrimitiveBatch(nullptr, target, GPU_LINES, batch.vertices.size() / 6, const_cast<float*>(batch.vertices.data()), batch.indices.size(), const_cast<unsigned short*>(batch.indices.data()), GPU_BATCH_XY_RGBA);
+        }
+    }
 }
\ No newline at end of file
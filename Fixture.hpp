@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <box2d/box2d.h>
+#include <SDL_gpu.h>
+
+namespace Fixture
+{
+    enum class Kind : int
+    {
+        NONE,
+        GROUND,
+        MAZE,
+        WALL,
+        START,
+        END,
+        CAR,
+        CHASSIS,
+        DIRECTION,
+        SENSOR,
+        FRICTION,
+        COUNT
+    };
+
+    // Attached as userData to bodies, fixtures and joints
+    struct Record
+    {
+        Kind kind;
+        SDL_Color border;
+        SDL_Color fill;
+    };
+
+    static constexpr auto color(Kind kind, Uint8 r, Uint8 g, Uint8 b) -> Record
+    {
+        return Record{ kind, SDL_Color{ r, g, b, 255 }, SDL_Color{ r, g, b, 64 } };
+    }
+
+    static constexpr std::array<Record, static_cast<int>(Kind::COUNT)> records{
+        Fixture::color(Kind::NONE, 255, 0, 255),
+        Fixture::color(Kind::GROUND, 255, 0, 255),
+        Fixture::color(Kind::MAZE, 255, 0, 255),
+        Fixture::color(Kind::WALL, 255, 0, 255),
+        Fixture::color(Kind::START, 0, 255, 0),
+        Fixture::color(Kind::END, 255, 0, 0),
+        Fixture::color(Kind::CAR, 255, 0, 255),
+        Fixture::color(Kind::CHASSIS, 255, 127, 0),
+        Fixture::color(Kind::DIRECTION, 255, 0, 255),
+        Fixture::color(Kind::SENSOR, 255, 255, 0),
+        Fixture::color(Kind::FRICTION, 255, 0, 255)
+    };
+
+    static auto tag(Kind kind) -> void*
+    {
+        return const_cast<Record*>(&records[static_cast<int>(kind)]);
+    }
+
+    static auto record(void* userData) -> const Record&
+    {
+        return userData != nullptr ? *reinterpret_cast<const Record*>(userData) : records[static_cast<int>(Kind::NONE)];
+    }
+
+    static auto record(const b2Fixture* fixture) -> const Record&
+    {
+        return Fixture::record(fixture->GetUserData());
+    }
+
+    static auto kind(const b2Fixture* fixture) -> Kind
+    {
+        return Fixture::record(fixture).kind;
+    }
+}
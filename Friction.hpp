@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <box2d/box2d.h>
+
+#include "Fixture.hpp"
+
+// Top-down ground friction for the cars, either as a joint to the ground or applied straight to the commanded velocities
+namespace Friction
+{
+    static constexpr float gravity{ 10.0f };
+    static constexpr float coefficient{ 0.1f };
+
+    // Radius of the ring with the same inertia as the body, where the friction torque acts
+    static auto radius(const b2Body* body) -> float
+    {
+        return b2Sqrt(2.0f * body->GetInertia() / body->GetMass());
+    }
+
+    static auto joint(b2World* world, b2Body* ground, b2Body* body) -> b2Joint*
+    {
+        const auto mass{ body->GetMass() };
+
+        b2FrictionJointDef jd{};
+        jd.bodyA = ground;
+        jd.bodyB = body;
+        jd.localAnchorA = b2Vec2{ 0.0f, 0.0f };
+        jd.localAnchorB = body->GetLocalCenter();
+        jd.collideConnected = true;
+        jd.maxForce = Friction::coefficient * mass * Friction::gravity;
+        jd.maxTorque = Friction::coefficient * mass * Friction::radius(body) * Friction::gravity;
+        jd.userData = Fixture::tag(Fixture::Kind::FRICTION);
+
+        return world->CreateJoint(&jd);
+    }
+
+    // What the joint would take off the velocities over one step: a Coulomb deceleration of at most mu * g, never reversing them
+    static auto apply(b2Body* body, float timeStep) -> void
+    {
+        const auto linear{ body->GetLinearVelocity() };
+        const auto speed{ linear.Length() };
+        if (speed > 0.0f)
+        {
+            const auto reduction{ std::min(speed, Friction::coefficient * Friction::gravity * timeStep) };
+            body->SetLinearVelocity((1.0f - reduction / speed) * linear);
+        }
+
+        // maxTorque / inertia, with the inertia written through the radius
+        const auto angular{ body->GetAngularVelocity() };
+        if (angular != 0.0f)
+        {
+            const auto reduction{ std::min(std::abs(angular), 2.0f * Friction::coefficient * Friction::gravity / Friction::radius(body) * timeStep) };
+            body->SetAngularVelocity(angular > 0.0f ? angular - reduction : angular + reduction);
+        }
+    }
+}
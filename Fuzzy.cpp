@@ -8,6 +8,7 @@
 #include "fl/Headers.h"
 
 #include "Fuzzy.hpp"
+#include "Profiler.hpp"
 
 Fuzzy::Fuzzy(const std::string& filePath)
 {
@@ -25,6 +26,8 @@ Fuzzy::~Fuzzy()
 
 auto Fuzzy::inference(const std::vector<float>& inputData) const->std::vector<float>
 {
+    const auto scope{ Profiler::Scope{ Profiler::Phase::FUZZY } };
+
     auto entradaFrente{ engine->getInputVariable("Sfrente") };
     auto entradaEsquerda{ engine->getInputVariable("Sesquerdo") };
     auto entradaDireita{ engine->getInputVariable("Sdireito") };
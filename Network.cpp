@@ -0,0 +1,162 @@
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <cassert>
+
+#include "Network.hpp"
+#include "Dense.hpp"
+
+Network::Network(const std::vector<int>& topology, std::mt19937& mt)
+{
+    assert(topology.size() >= 2);
+
+    for (auto n{ 1 }; n < topology.size(); ++n)
+    {
+        auto& layer{ this->layers.emplace_back() };
+        layer.inputs = topology[n - 1];
+        layer.outputs = topology[n];
+        layer.activation = (n + 1 == topology.size() ? Activation::SOFTMAX : Activation::RELU);
+        layer.weights.resize(layer.inputs * layer.outputs);
+        layer.biases.resize(layer.outputs, 0.0f);
+
+        // He initialization
+        auto dist{ std::normal_distribution{ 0.0f, std::sqrt(2.0f / layer.inputs) } };
+        for (auto& weight : layer.weights)
+        {
+            weight = dist(mt);
+        }
+    }
+}
+
+Network::Network(const std::string& filePath)
+{
+    auto file{ std::ifstream{ filePath } };
+    assert(file.is_open());
+
+    auto header{ std::string{} };
+    auto count{ 0 };
+    file >> header >> count;
+    assert(header == "mlp");
+
+    this->layers.resize(count);
+    for (auto& layer : this->layers)
+    {
+        auto activation{ 0 };
+        file >> layer.inputs >> layer.outputs >> activation;
+        layer.activation = static_cast<Activation>(activation);
+
+        layer.weights.resize(layer.inputs * layer.outputs);
+        for (auto& weight : layer.weights)
+        {
+            file >> weight;
+        }
+
+        layer.biases.resize(layer.outputs);
+        for (auto& bias : layer.biases)
+        {
+            file >> bias;
+        }
+    }
+    assert(not file.fail());
+}
+
+auto Network::activate(Activation activation, float* values, int count) -> void
+{
+    if (activation == Activation::RELU)
+    {
+        for (auto n{ 0 }; n < count; ++n)
+        {
+            values[n] = std::max(values[n], 0.0f);
+        }
+    }
+    else if (activation == Activation::SOFTMAX)
+    {
+        const auto max{ *std::max_element(values, values + count) };
+        auto sum{ 0.0f };
+        for (auto n{ 0 }; n < count; ++n)
+        {
+            values[n] = std::exp(values[n] - max);
+            sum += values[n];
+        }
+        for (auto n{ 0 }; n < count; ++n)
+        {
+            values[n] /= sum;
+        }
+    }
+}
+
+auto Network::inference(const std::vector<float>& inputData) const -> std::vector<float>
+{
+    assert(not this->layers.empty() and inputData.size() == this->layers.front().inputs);
+
+    auto values{ inputData };
+    auto outputs{ std::vector<float>{} };
+
+    for (const auto& layer : this->layers)
+    {
+        outputs.resize(layer.outputs);
+        Dense::forward(layer.weights.data(), layer.biases.data(), values.data(), outputs.data(), layer.inputs, layer.outputs);
+
+        Network::activate(layer.activation, outputs.data(), layer.outputs);
+        std::swap(values, outputs);
+    }
+
+    return values;
+}
+
+auto Network::save(const std::string& filePath) const -> void
+{
+    auto ofs{ std::ofstream{ filePath } };
+    ofs.precision(9);
+
+    ofs << "mlp " << this->layers.size() << '\n';
+    for (const auto& layer : this->layers)
+    {
+        ofs << layer.inputs << ' ' << layer.outputs << ' ' << static_cast<int>(layer.activation) << '\n';
+
+        for (auto o{ 0 }; o < layer.outputs; ++o)
+        {
+            for (auto i{ 0 }; i < layer.inputs; ++i)
+            {
+                ofs << layer.weights[o * layer.inputs + i] << ' ';
+            }
+            ofs << '\n';
+        }
+
+        for (const auto& bias : layer.biases)
+        {
+            ofs << bias << ' ';
+        }
+        ofs << '\n';
+    }
+}
+
+auto Network::topology() const -> std::vector<int>
+{
+    auto topology{ std::vector<int>{} };
+    if (not this->layers.empty())
+    {
+        topology.emplace_back(this->layers.front().inputs);
+    }
+    for (const auto& layer : this->layers)
+    {
+        topology.emplace_back(layer.outputs);
+    }
+    return topology;
+}
+
+auto Network::size() const -> size_t
+{
+    return this->layers.size();
+}
+
+auto Network::layer(size_t n) -> Layer&
+{
+    return this->layers[n];
+}
+
+auto Network::layer(size_t n) const -> const Layer&
+{
+    return this->layers[n];
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <random>
+
+class Network
+{
+public:
+    enum class Activation
+    {
+        LINEAR = 0,
+        RELU,
+        SOFTMAX
+    };
+
+    struct Layer
+    {
+        int inputs;
+        int outputs;
+        Activation activation;
+        std::vector<float> weights; // outputs x inputs, row-major
+        std::vector<float> biases;
+    };
+
+    Network() = default;
+    Network(const std::vector<int>& topology, std::mt19937& mt);
+    Network(const std::string& filePath);
+
+    auto inference(const std::vector<float>& inputData) const -> std::vector<float>;
+    auto save(const std::string& filePath) const -> void;
+
+    auto topology() const -> std::vector<int>;
+    auto size() const -> size_t;
+    auto layer(size_t n) -> Layer&;
+    auto layer(size_t n) const -> const Layer&;
+
+    static auto activate(Activation activation, float* values, int count) -> void;
+
+private:
+
+    std::vector<Layer> layers{};
+};
@@ -4,13 +4,23 @@
 #include <cassert>
 #include <cstdint>
 #include <iostream>
+#include <cstring>
+#include <filesystem>
 
 #include <tensorflow/c/c_api.h>
 
 #include "Neural.hpp"
+#include "Profiler.hpp"
 
 Neural::Neural(const std::string& folderPath)
 {
+    // Models trained in-process are single files in the Network format
+    if (std::filesystem::is_regular_file(folderPath))
+    {
+        this->network = std::make_unique<Network>(folderPath);
+        return;
+    }
+
     this->status = TF_NewStatus();
     this->graph = TF_NewGraph();
 
@@ -59,6 +69,11 @@ Neural::Neural(const std::string& folderPath)
 
 Neural::~Neural()
 {
+    if (this->session == nullptr)
+    {
+        return;
+    }
+
     TF_CloseSession(session, status);
     TF_DeleteGraph(graph);
     TF_DeleteSession(session, status);
@@ -105,6 +120,13 @@ auto Neural::vectorToTensor(const std::vector<float>& vector, TF_Output output)
 
 auto Neural::inference(const std::vector<float>& inputData) const->std::vector<float>
 {
+    const auto scope{ Profiler::Scope{ Profiler::Phase::NEURAL } };
+
+    if (this->network != nullptr)
+    {
+        return this->network->inference(inputData);
+    }
+
     const auto inputTensor{ this->vectorToTensor(inputData, input) };
     auto outputTensor{ static_cast<TF_Tensor*>(nullptr) };
 
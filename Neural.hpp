@@ -2,9 +2,12 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 #include <tensorflow/c/c_api.h>
 
+#include "Network.hpp"
+
 class Neural
 {
 public:
@@ -29,4 +32,6 @@ private:
     TF_Output output{ };
     TF_Operation* saveOperation{ nullptr };
     TF_Output save{ };
+
+    std::unique_ptr<Network> network{};
 };
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cassert>
+
+#include <box2d/box2d.h>
+
+#include "Noise.hpp"
+
+Noise::Noise(const std::string& filePath)
+{
+    auto file{ std::ifstream{ filePath } };
+    assert(file.is_open());
+
+    auto line{ std::string{} };
+    std::getline(file, line);
+    assert(line == "sensor;bin;count;bias;deviation;dropout;");
+
+    while (std::getline(file, line))
+    {
+        auto iss{ std::istringstream{ line } };
+
+        auto angle{ 0 }, index{ 0 };
+        auto bin{ Bin{} };
+        auto separator{ ';' };
+
+        iss >> angle >> separator
+            >> index >> separator
+            >> bin.count >> separator
+            >> bin.bias >> separator
+            >> bin.deviation >> separator
+            >> bin.dropout >> separator;
+
+        if (iss.fail())
+        {
+            continue;
+        }
+
+        if (index < 0)
+        {
+            this->totals[angle] = bin;
+        }
+        else if (index < distanceBins * incidenceBins)
+        {
+            this->bins[angle][index] = bin;
+        }
+    }
+}
+
+auto Noise::bin(float distance, float incidence) -> int
+{
+    const auto d{ std::clamp(static_cast<int>(distance / Sensor::maxDistance * distanceBins), 0, distanceBins - 1) };
+    const auto i{ std::clamp(static_cast<int>(incidence / (b2_pi / 2.0f) * incidenceBins), 0, incidenceBins - 1) };
+
+    return d * incidenceBins + i;
+}
+
+auto Noise::fit(const std::vector<Divergence::Report>& reports) -> Noise
+{
+    // Residuals go into Statistics::add, dropouts (no echo from a reachable wall) into Statistics::misses
+    using Accumulator = std::map<int, std::array<Divergence::Statistics, distanceBins * incidenceBins>>;
+
+    auto frames{ std::vector<std::pair<const Divergence::Report*, const Divergence::Frame*>>{} };
+    for (const auto& report : reports)
+    {
+        for (const auto& frame : report.frames)
+        {
+            frames.emplace_back(&report, &frame);
+        }
+    }
+
+    const auto chunks{ static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) };
+    auto accumulators{ std::vector<Accumulator>(chunks) };
+
+#pragma omp parallel for
+    for (auto n{ 0 }; n < chunks; ++n)
+    {
+        auto& accumulator{ accumulators[n] };
+
+        const auto begin{ frames.size() * n / chunks };
+        const auto end{ frames.size() * (n + 1) / chunks };
+        for (auto k{ begin }; k < end; ++k)
+        {
+            const auto [report, frame] { frames[k] };
+            for (auto s{ 0 }; s < frame->recorded.size(); ++s)
+            {
+                const auto& simulated{ frame->simulated[s] };
+                if (not simulated.valid)
+                {
+                    continue;
+                }
+
+                auto& statistics{ accumulator[report->angles[s]][Noise::bin(simulated.distance, simulated.incidence)] };
+                if (frame->recorded[s] >= dropoutDistance)
+                {
+                    ++statistics.misses;
+                }
+                else
+                {
+                    statistics.add(frame->recorded[s] - simulated.distance);
+                }
+            }
+        }
+    }
+
+    for (auto n{ 1 }; n < chunks; ++n)
+    {
+        for (const auto& [angle, statistics] : accumulators[n])
+        {
+            auto& merged{ accumulators.front()[angle] };
+            for (auto k{ 0 }; k < statistics.size(); ++k)
+            {
+                merged[k].merge(statistics[k]);
+            }
+        }
+    }
+
+    const auto toBin{ [](const Divergence::Statistics& statistics) -> Bin
+    {
+        const auto count{ statistics.count + statistics.misses };
+        return Bin{
+            count,
+            static_cast<float>(statistics.mean),
+            static_cast<float>(statistics.deviation()),
+            count > 0 ? static_cast<float>(statistics.misses) / count : 0.0f
+        };
+    } };
+
+    auto noise{ Noise{} };
+    for (const auto& [angle, statistics] : accumulators.front())
+    {
+        auto total{ Divergence::Statistics{} };
+        for (auto k{ 0 }; k < statistics.size(); ++k)
+        {
+            noise.bins[angle][k] = toBin(statistics[k]);
+            total.merge(statistics[k]);
+        }
+        noise.totals[angle] = toBin(total);
+    }
+
+    return noise;
+}
+
+auto Noise::save(const std::string& filePath) const -> void
+{
+    auto ofs{ std::ofstream{ filePath } };
+
+    ofs << "sensor;bin;count;bias;deviation;dropout;\n";
+
+    const auto write{ [&](int angle, int index, const Bin& bin)
+    {
+        ofs << angle << ';' << index << ';' << bin.count << ';' << bin.bias << ';' << bin.deviation << ';' << bin.dropout << ";\n";
+    } };
+
+    for (const auto& [angle, total] : this->totals)
+    {
+        write(angle, -1, total);
+    }
+
+    for (const auto& [angle, bins] : this->bins)
+    {
+        for (auto k{ 0 }; k < bins.size(); ++k)
+        {
+            if (bins[k].count > 0)
+            {
+                write(angle, k, bins[k]);
+            }
+        }
+    }
+}
+
+auto Noise::contains(int angle) const -> bool
+{
+    return this->totals.find(angle) != this->totals.end();
+}
+
+auto Noise::sample(int angle, float distance, float incidence, std::mt19937& mt) const -> float
+{
+    // Sparse bins fall back to the distribution fitted over every frame of the sensor
+    auto bin{ this->totals.at(angle) };
+    {
+        const auto it{ this->bins.find(angle) };
+        if (it != this->bins.end())
+        {
+            const auto& candidate{ it->second[Noise::bin(distance, incidence)] };
+            if (candidate.count >= minimumCount)
+            {
+                bin = candidate;
+            }
+        }
+    }
+
+    auto dropout{ std::bernoulli_distribution{ bin.dropout } };
+    if (dropout(mt))
+    {
+        return Sensor::maxDistance;
+    }
+
+    auto dist{ std::normal_distribution{ bin.bias, std::max(bin.deviation, 1e-6f) } };
+    return distance + dist(mt);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <array>
+#include <map>
+#include <random>
+
+#include "Divergence.hpp"
+
+class Noise
+{
+public:
+    struct Bin
+    {
+        int count;
+        float bias;
+        float deviation;
+        float dropout;
+    };
+
+    Noise() = default;
+    Noise(const std::string& filePath);
+
+    static auto fit(const std::vector<Divergence::Report>& reports) -> Noise;
+    auto save(const std::string& filePath) const -> void;
+
+    auto contains(int angle) const -> bool;
+    auto sample(int angle, float distance, float incidence, std::mt19937& mt) const -> float;
+
+    static constexpr int distanceBins{ 20 };
+    static constexpr int incidenceBins{ 3 };
+    static constexpr int minimumCount{ 10 };
+    static constexpr float dropoutDistance{ Sensor::maxDistance - 0.005f };
+
+private:
+    using Bins = std::array<Bin, distanceBins * incidenceBins>;
+
+    static auto bin(float distance, float incidence) -> int;
+
+    std::map<int, Bins> bins{};
+    std::map<int, Bin> totals{};
+};
@@ -0,0 +1,290 @@
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "Profiler.hpp"
+
+namespace Profiler
+{
+    struct Histogram
+    {
+        std::array<std::atomic<uint64_t>, buckets> counts{};
+        std::atomic<uint64_t> count{ 0 };
+        std::atomic<uint64_t> total{ 0 };
+        std::atomic<uint64_t> maximum{ 0 };
+    };
+
+    struct Event
+    {
+        Phase phase;
+        int64_t start;
+        int64_t duration;
+    };
+
+    // One per thread, the lock is only ever contended while saving
+    struct Log
+    {
+        int thread;
+        std::mutex mutex;
+        std::vector<Event> events;
+    };
+
+    static std::array<Histogram, static_cast<int>(Phase::COUNT)> histograms{};
+
+    // step, collide, solve, solveInit, solveVelocity, solvePosition, broadphase, solveTOI, in nanoseconds
+    static constexpr int fields{ sizeof(b2Profile) / sizeof(float) };
+    static constexpr std::array<const char*, fields> fieldNames{
+        "step", "collide", "solve", "solveInit", "solveVelocity", "solvePosition", "broadphase", "solveTOI"
+    };
+    static std::array<std::atomic<uint64_t>, fields> physicsTotal{};
+    static std::array<std::atomic<uint64_t>, fields> physicsMaximum{};
+    static std::atomic<uint64_t> physicsSteps{ 0 };
+    static std::atomic<bool> tracing{ false };
+    static std::mutex logsMutex{};
+    static std::vector<std::unique_ptr<Log>> logs{};
+    static const auto epoch{ std::chrono::steady_clock::now() };
+
+    static auto bucket(uint64_t nanoseconds) -> int
+    {
+        if (nanoseconds < subBuckets)
+        {
+            return static_cast<int>(nanoseconds);
+        }
+
+        auto exponent{ 0 };
+        while ((nanoseconds >> (exponent + 1)) != 0)
+        {
+            ++exponent;
+        }
+        return subBuckets * (exponent - 1) + static_cast<int>((nanoseconds >> (exponent - 2)) & (subBuckets - 1));
+    }
+
+    // Middle of the bucket range, in nanoseconds
+    static auto value(int bucket) -> double
+    {
+        if (bucket < subBuckets)
+        {
+            return bucket;
+        }
+
+        const auto exponent{ bucket / subBuckets + 1 };
+        const auto lower{ static_cast<double>((subBuckets + bucket % subBuckets) * (uint64_t{ 1 } << (exponent - 2))) };
+        return lower + (uint64_t{ 1 } << (exponent - 2)) / 2.0;
+    }
+
+    static auto log() -> Log&
+    {
+        thread_local auto* current{ static_cast<Log*>(nullptr) };
+        if (current == nullptr)
+        {
+            const auto lock{ std::lock_guard<std::mutex>{ logsMutex } };
+            current = logs.emplace_back(std::make_unique<Log>()).get();
+            current->thread = static_cast<int>(logs.size());
+        }
+        return *current;
+    }
+
+    auto record(Phase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) -> void
+    {
+        const auto nanoseconds{ static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) };
+
+        auto& histogram{ histograms[static_cast<int>(phase)] };
+        histogram.counts[bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        histogram.count.fetch_add(1, std::memory_order_relaxed);
+        histogram.total.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+        auto maximum{ histogram.maximum.load(std::memory_order_relaxed) };
+        while (nanoseconds > maximum and not histogram.maximum.compare_exchange_weak(maximum, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+
+        if (tracing.load(std::memory_order_relaxed))
+        {
+            auto& current{ log() };
+            const auto lock{ std::lock_guard<std::mutex>{ current.mutex } };
+            current.events.emplace_back(Event{
+                phase,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count(),
+                static_cast<int64_t>(nanoseconds)
+            });
+        }
+    }
+
+    auto summary(Phase phase) -> Summary
+    {
+        const auto& histogram{ histograms[static_cast<int>(phase)] };
+
+        auto summary{ Summary{} };
+        summary.count = histogram.count.load(std::memory_order_relaxed);
+        summary.total = histogram.total.load(std::memory_order_relaxed) / 1e6;
+        summary.maximum = histogram.maximum.load(std::memory_order_relaxed) / 1e6;
+        if (summary.count == 0)
+        {
+            return summary;
+        }
+
+        auto accumulated{ uint64_t{ 0 } };
+        for (auto n{ 0 }; n < buckets; ++n)
+        {
+            accumulated += histogram.counts[n].load(std::memory_order_relaxed);
+            if (summary.p50 == 0.0 and accumulated * 2 >= summary.count)
+            {
+                summary.p50 = value(n) / 1e6;
+            }
+            if (accumulated * 100 >= summary.count * 99)
+            {
+                summary.p99 = value(n) / 1e6;
+                break;
+            }
+        }
+        return summary;
+    }
+
+    auto reset() -> void
+    {
+        for (auto& histogram : histograms)
+        {
+            for (auto& count : histogram.counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+            histogram.count.store(0, std::memory_order_relaxed);
+            histogram.total.store(0, std::memory_order_relaxed);
+            histogram.maximum.store(0, std::memory_order_relaxed);
+        }
+        for (auto n{ 0 }; n < fields; ++n)
+        {
+            physicsTotal[n].store(0, std::memory_order_relaxed);
+            physicsMaximum[n].store(0, std::memory_order_relaxed);
+        }
+        physicsSteps.store(0, std::memory_order_relaxed);
+    }
+
+    auto print(std::ostringstream& oss) -> void
+    {
+        oss << std::fixed << std::setprecision(3);
+        for (auto n{ 0 }; n < static_cast<int>(Phase::COUNT); ++n)
+        {
+            const auto summary{ Profiler::summary(static_cast<Phase>(n)) };
+            if (summary.count == 0)
+            {
+                continue;
+            }
+            oss << names[n] << " = " << summary.total / summary.count << " ms"
+                << " (p50 " << summary.p50 << ", p99 " << summary.p99 << ", max " << summary.maximum << ", n " << summary.count << ")" << '\n';
+        }
+
+        const auto physics{ Profiler::physics() };
+        if (physics.steps > 0)
+        {
+            const auto mean{ [&](float total) { return total / physics.steps; } };
+            oss << "b2 step = " << mean(physics.total.step) << " ms (max " << physics.maximum.step << ", n " << physics.steps << ")" << '\n'
+                << "b2 collide = " << mean(physics.total.collide) << " | solve = " << mean(physics.total.solve)
+                << " | broadphase = " << mean(physics.total.broadphase) << " | toi = " << mean(physics.total.solveTOI) << '\n';
+        }
+        oss << std::defaultfloat;
+    }
+
+    auto record(const b2Profile& profile) -> void
+    {
+        const auto* milliseconds{ reinterpret_cast<const float*>(&profile) };
+        for (auto n{ 0 }; n < fields; ++n)
+        {
+            const auto nanoseconds{ static_cast<uint64_t>(std::max(0.0f, milliseconds[n]) * 1e6f) };
+            physicsTotal[n].fetch_add(nanoseconds, std::memory_order_relaxed);
+
+            auto maximum{ physicsMaximum[n].load(std::memory_order_relaxed) };
+            while (nanoseconds > maximum and not physicsMaximum[n].compare_exchange_weak(maximum, nanoseconds, std::memory_order_relaxed))
+            {
+            }
+        }
+        physicsSteps.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // In milliseconds, like b2Profile itself
+    auto physics() -> Physics
+    {
+        auto physics{ Physics{} };
+        physics.steps = physicsSteps.load(std::memory_order_relaxed);
+
+        auto* total{ reinterpret_cast<float*>(&physics.total) };
+        auto* maximum{ reinterpret_cast<float*>(&physics.maximum) };
+        for (auto n{ 0 }; n < fields; ++n)
+        {
+            total[n] = physicsTotal[n].load(std::memory_order_relaxed) / 1e6f;
+            maximum[n] = physicsMaximum[n].load(std::memory_order_relaxed) / 1e6f;
+        }
+        return physics;
+    }
+
+    auto header(std::ostream& os) -> void
+    {
+        os << "seconds;steps;";
+        for (const auto& name : fieldNames)
+        {
+            os << name << "_mean;" << name << "_max;";
+        }
+        os << '\n';
+    }
+
+    // One CSV line with the mean and maximum per step of every b2Profile field, in milliseconds
+    auto row(std::ostream& os, double seconds) -> void
+    {
+        const auto physics{ Profiler::physics() };
+        const auto* total{ reinterpret_cast<const float*>(&physics.total) };
+        const auto* maximum{ reinterpret_cast<const float*>(&physics.maximum) };
+
+        os << seconds << ';' << physics.steps << ';';
+        for (auto n{ 0 }; n < fields; ++n)
+        {
+            os << (physics.steps > 0 ? total[n] / physics.steps : 0.0f) << ';' << maximum[n] << ';';
+        }
+        os << '\n';
+    }
+
+    auto trace(bool enabled) -> void
+    {
+        if (enabled)
+        {
+            const auto lock{ std::lock_guard<std::mutex>{ logsMutex } };
+            for (auto& current : logs)
+            {
+                const auto lock{ std::lock_guard<std::mutex>{ current->mutex } };
+                current->events.clear();
+            }
+        }
+        tracing.store(enabled);
+    }
+
+    auto isTracing() -> bool
+    {
+        return tracing.load();
+    }
+
+    // Complete ("X") events in microseconds, one track per thread
+    auto save(const std::string& filePath) -> void
+    {
+        auto ofs{ std::ofstream{ filePath } };
+        ofs << std::fixed << std::setprecision(3);
+        ofs << "{\"traceEvents\":[";
+
+        auto first{ true };
+        const auto lock{ std::lock_guard<std::mutex>{ logsMutex } };
+        for (auto& current : logs)
+        {
+            const auto lock{ std::lock_guard<std::mutex>{ current->mutex } };
+            for (const auto& event : current->events)
+            {
+                ofs << (first ? "" : ",") << '\n'
+                    << "{\"name\":\"" << names[static_cast<int>(event.phase)] << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << current->thread
+                    << ",\"ts\":" << event.start / 1e3 << ",\"dur\":" << event.duration / 1e3 << "}";
+                first = false;
+            }
+        }
+
+        ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+}
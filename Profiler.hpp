@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <cstdint>
+#include <box2d/box2d.h>
+
+// Scoped timers feeding per-phase histograms, plus an optional event log exported as Chrome trace JSON
+namespace Profiler
+{
+    enum class Phase : int
+    {
+        TICK,
+        SENSE,
+        NEURAL,
+        FUZZY,
+        FOLLOWER,
+        SOLVE,
+        CAR,
+        WORLD,
+        PUBLISH,
+        RENDER,
+        FLIP,
+        FRAME,
+        COUNT
+    };
+
+    static constexpr std::array<const char*, static_cast<int>(Phase::COUNT)> names{
+        "tick", "sense", "neural", "fuzzy", "follower", "solve", "car", "world", "publish", "render", "flip", "frame"
+    };
+
+    // Log-linear buckets over nanoseconds, 4 per power of two, so percentiles are within 19%
+    static constexpr int subBuckets{ 4 };
+    static constexpr int buckets{ 64 * subBuckets };
+
+    struct Summary
+    {
+        uint64_t count;
+        double total;
+        double p50;
+        double p99;
+        double maximum;
+    };
+
+    auto record(Phase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) -> void;
+    auto summary(Phase phase) -> Summary;
+    auto reset() -> void;
+    auto print(std::ostringstream& oss) -> void;
+
+    // Box2D's own step breakdown, summed over every world stepped since the last reset
+    struct Physics
+    {
+        uint64_t steps;
+        b2Profile total;
+        b2Profile maximum;
+    };
+
+    auto record(const b2Profile& profile) -> void;
+    auto physics() -> Physics;
+    auto header(std::ostream& os) -> void;
+    auto row(std::ostream& os, double seconds) -> void;
+
+    auto trace(bool enabled) -> void;
+    auto isTracing() -> bool;
+    auto save(const std::string& filePath) -> void;
+
+    class Scope
+    {
+    public:
+        Scope(Phase phase)
+        {
+            this->phase = phase;
+            this->start = std::chrono::steady_clock::now();
+        }
+
+        ~Scope()
+        {
+            Profiler::record(this->phase, this->start, std::chrono::steady_clock::now());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+
+    private:
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+}
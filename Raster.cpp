@@ -0,0 +1,191 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Raster.hpp"
+
+Raster::Raster(int width, int height)
+{
+    this->columns = width;
+    this->rows = height;
+    this->rgb.resize(3 * width * height);
+    this->bounds.lowerBound = b2Vec2{ 0.0f, 0.0f };
+    this->bounds.upperBound = b2Vec2{ static_cast<float>(width), static_cast<float>(height) };
+}
+
+// Same orientation as the window projection, lower bound at the top left corner
+auto Raster::view(const b2AABB& bounds) -> void
+{
+    this->bounds = bounds;
+}
+
+auto Raster::clear(const SDL_Color& color) -> void
+{
+    for (auto n{ 0 }; n < this->rgb.size(); n += 3)
+    {
+        this->rgb[n + 0] = color.r;
+        this->rgb[n + 1] = color.g;
+        this->rgb[n + 2] = color.b;
+    }
+}
+
+auto Raster::draw(const Draw::Mesh& mesh, bool filled) -> void
+{
+    if (filled)
+    {
+        for (const auto& batch : mesh.triangles)
+        {
+            for (auto n{ 0 }; n + 2 < batch.indices.size(); n += 3)
+            {
+                this->triangle(&batch.vertices[batch.indices[n + 0] * 6], &batch.vertices[batch.indices[n + 1] * 6], &batch.vertices[batch.indices[n + 2] * 6]);
+            }
+        }
+    }
+    for (const auto& batch : mesh.lines)
+    {
+        for (auto n{ 0 }; n + 1 < batch.indices.size(); n += 2)
+        {
+            this->line(&batch.vertices[batch.indices[n + 0] * 6], &batch.vertices[batch.indices[n + 1] * 6]);
+        }
+    }
+}
+
+// Mirrors Simulation::render, culling against the current view
+auto Raster::draw(const Snapshot& snapshot, bool detailed) -> void
+{
+    Draw::clear(this->list);
+
+    for (const auto& path : snapshot.paths)
+    {
+        if (not b2TestOverlap(this->bounds, path.bounds))
+        {
+            continue;
+        }
+        for (auto n{ 1 }; n < path.points.size(); ++n)
+        {
+            Draw::append(this->list, path.points[n - 1], path.points[n], Snapshot::pathColor);
+        }
+    }
+
+    for (const auto& body : snapshot.bodies)
+    {
+        if (not b2TestOverlap(this->bounds, body.bounds))
+        {
+            continue;
+        }
+        Draw::append(this->list, *body.shape, body.transform, detailed);
+        if (detailed)
+        {
+            for (const auto& [start, end] : body.beams)
+            {
+                Draw::append(this->list, start, end, Snapshot::beamColor);
+            }
+        }
+    }
+
+    this->draw(this->list, detailed);
+
+    for (const auto& item : snapshot.statics)
+    {
+        if (not b2TestOverlap(this->bounds, item.bounds))
+        {
+            continue;
+        }
+        this->draw(*item.mesh, detailed);
+    }
+}
+
+auto Raster::width() const -> int
+{
+    return this->columns;
+}
+
+auto Raster::height() const -> int
+{
+    return this->rows;
+}
+
+auto Raster::pixels() const -> const std::vector<uint8_t>&
+{
+    return this->rgb;
+}
+
+auto Raster::toPixel(float x, float y) const -> b2Vec2
+{
+    const auto& [lower, upper] { this->bounds };
+    return b2Vec2{
+        (x - lower.x) / (upper.x - lower.x) * this->columns,
+        (y - lower.y) / (upper.y - lower.y) * this->rows
+    };
+}
+
+auto Raster::blend(int x, int y, const float* color) -> void
+{
+    if (x < 0 or y < 0 or x >= this->columns or y >= this->rows)
+    {
+        return;
+    }
+
+    auto* pixel{ &this->rgb[3 * (y * this->columns + x)] };
+    const auto alpha{ color[3] };
+    for (auto c{ 0 }; c < 3; ++c)
+    {
+        pixel[c] = static_cast<uint8_t>(pixel[c] + (color[c] * 255.0f - pixel[c]) * alpha);
+    }
+}
+
+// Edge functions over the bounding box, sampled at pixel centers
+auto Raster::triangle(const float* a, const float* b, const float* c) -> void
+{
+    auto p0{ this->toPixel(a[0], a[1]) };
+    auto p1{ this->toPixel(b[0], b[1]) };
+    auto p2{ this->toPixel(c[0], c[1]) };
+
+    const auto area{ (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x) };
+    if (area == 0.0f)
+    {
+        return;
+    }
+    if (area < 0.0f)
+    {
+        std::swap(p1, p2);
+    }
+
+    const auto x0{ std::max(0, static_cast<int>(std::floor(std::min({ p0.x, p1.x, p2.x })))) };
+    const auto x1{ std::min(this->columns - 1, static_cast<int>(std::ceil(std::max({ p0.x, p1.x, p2.x })))) };
+    const auto y0{ std::max(0, static_cast<int>(std::floor(std::min({ p0.y, p1.y, p2.y })))) };
+    const auto y1{ std::min(this->rows - 1, static_cast<int>(std::ceil(std::max({ p0.y, p1.y, p2.y })))) };
+
+    const auto edge{ [](const b2Vec2& from, const b2Vec2& to, float x, float y)
+    {
+        return (to.x - from.x) * (y - from.y) - (to.y - from.y) * (x - from.x);
+    } };
+
+    for (auto y{ y0 }; y <= y1; ++y)
+    {
+        for (auto x{ x0 }; x <= x1; ++x)
+        {
+            const auto px{ x + 0.5f };
+            const auto py{ y + 0.5f };
+            if (edge(p0, p1, px, py) >= 0.0f and edge(p1, p2, px, py) >= 0.0f and edge(p2, p0, px, py) >= 0.0f)
+            {
+                this->blend(x, y, &a[2]);
+            }
+        }
+    }
+}
+
+// One pixel wide DDA
+auto Raster::line(const float* a, const float* b) -> void
+{
+    const auto p0{ this->toPixel(a[0], a[1]) };
+    const auto p1{ this->toPixel(b[0], b[1]) };
+
+    const auto steps{ std::max(1, static_cast<int>(std::ceil(std::max(std::abs(p1.x - p0.x), std::abs(p1.y - p0.y))))) };
+    for (auto n{ 0 }; n <= steps; ++n)
+    {
+        const auto t{ static_cast<float>(n) / steps };
+        const auto x{ static_cast<int>(std::floor(p0.x + (p1.x - p0.x) * t)) };
+        const auto y{ static_cast<int>(std::floor(p0.y + (p1.y - p0.y) * t)) };
+        this->blend(x, y, &a[2]);
+    }
+}
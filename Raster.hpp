@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <box2d/box2d.h>
+#include <SDL_gpu.h>
+
+#include "Draw.hpp"
+#include "Simulation\Snapshot.hpp"
+
+// Software rasteriser for the same meshes Draw::draw submits to the GPU, for capturing frames without a display
+class Raster
+{
+public:
+    Raster(int width, int height);
+
+    auto view(const b2AABB& bounds) -> void;
+    auto clear(const SDL_Color& color) -> void;
+    auto draw(const Draw::Mesh& mesh, bool filled = true) -> void;
+    auto draw(const Snapshot& snapshot, bool detailed = true) -> void;
+
+    auto width() const -> int;
+    auto height() const -> int;
+    auto pixels() const -> const std::vector<uint8_t>&;
+
+private:
+    auto toPixel(float x, float y) const -> b2Vec2;
+    auto blend(int x, int y, const float* color) -> void;
+    auto triangle(const float* a, const float* b, const float* c) -> void;
+    auto line(const float* a, const float* b) -> void;
+
+    int columns{ 0 };
+    int rows{ 0 };
+    b2AABB bounds{};
+    std::vector<uint8_t> rgb{};
+    Draw::Mesh list{};
+};
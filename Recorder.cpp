@@ -0,0 +1,126 @@
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+#include <filesystem>
+
+#include "Recorder.hpp"
+
+Recorder::Recorder(const std::string& path, int width, int height, int fps, Format format)
+{
+    // 4:2:0 chroma needs even dimensions
+    assert(width % 2 == 0 and height % 2 == 0);
+
+    this->path = path;
+    this->width = width;
+    this->height = height;
+    this->format = format;
+
+    if (this->format == Format::Y4M)
+    {
+        this->file.open(path, std::ios::binary);
+        this->file << "YUV4MPEG2 W" << width << " H" << height << " F" << fps << ":1 Ip A1:1 C420jpeg\n";
+        this->yuv.resize(width * height * 3 / 2);
+    }
+    else
+    {
+        std::filesystem::create_directories(path);
+    }
+
+    this->worker = std::thread{ [this] { this->work(); } };
+}
+
+Recorder::~Recorder()
+{
+    {
+        const auto lock{ std::lock_guard<std::mutex>{ this->mutex } };
+        this->closing = true;
+    }
+    this->condition.notify_all();
+    this->worker.join();
+}
+
+auto Recorder::push(std::vector<uint8_t> frame) -> void
+{
+    assert(frame.size() == 3 * this->width * this->height);
+
+    {
+        auto lock{ std::unique_lock<std::mutex>{ this->mutex } };
+        this->condition.wait(lock, [this] { return this->queue.size() < Recorder::capacity; });
+        this->queue.emplace_back(std::move(frame));
+    }
+    this->condition.notify_all();
+}
+
+auto Recorder::frames() const -> int
+{
+    return this->written;
+}
+
+auto Recorder::work() -> void
+{
+    while (true)
+    {
+        auto frame{ std::vector<uint8_t>{} };
+        {
+            auto lock{ std::unique_lock<std::mutex>{ this->mutex } };
+            this->condition.wait(lock, [this] { return this->closing or not this->queue.empty(); });
+            if (this->queue.empty())
+            {
+                return;
+            }
+            frame = std::move(this->queue.front());
+            this->queue.pop_front();
+        }
+        this->condition.notify_all();
+
+        this->write(frame);
+        ++this->written;
+    }
+}
+
+auto Recorder::write(const std::vector<uint8_t>& frame) -> void
+{
+    if (this->format == Format::PPM)
+    {
+        char name[32]{};
+        std::snprintf(name, sizeof(name), "frame_%06d.ppm", this->written.load());
+
+        auto ofs{ std::ofstream{ (std::filesystem::path{ this->path } / name).string(), std::ios::binary } };
+        ofs << "P6\n" << this->width << ' ' << this->height << "\n255\n";
+        ofs.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+        return;
+    }
+
+    // Full range BT.601, chroma averaged over 2x2 blocks
+    auto* luma{ this->yuv.data() };
+    auto* cb{ luma + this->width * this->height };
+    auto* cr{ cb + this->width * this->height / 4 };
+
+    for (auto y{ 0 }; y < this->height; ++y)
+    {
+        for (auto x{ 0 }; x < this->width; ++x)
+        {
+            const auto* rgb{ &frame[3 * (y * this->width + x)] };
+            luma[y * this->width + x] = static_cast<uint8_t>(std::clamp(0.299f * rgb[0] + 0.587f * rgb[1] + 0.114f * rgb[2], 0.0f, 255.0f));
+        }
+    }
+    for (auto y{ 0 }; y < this->height / 2; ++y)
+    {
+        for (auto x{ 0 }; x < this->width / 2; ++x)
+        {
+            auto r{ 0.0f }, g{ 0.0f }, b{ 0.0f };
+            for (const auto& [dx, dy] : { std::pair{ 0, 0 }, std::pair{ 1, 0 }, std::pair{ 0, 1 }, std::pair{ 1, 1 } })
+            {
+                const auto* rgb{ &frame[3 * ((2 * y + dy) * this->width + 2 * x + dx)] };
+                r += rgb[0] / 4.0f;
+                g += rgb[1] / 4.0f;
+                b += rgb[2] / 4.0f;
+            }
+            cb[y * this->width / 2 + x] = static_cast<uint8_t>(std::clamp(128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b, 0.0f, 255.0f));
+            cr[y * this->width / 2 + x] = static_cast<uint8_t>(std::clamp(128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b, 0.0f, 255.0f));
+        }
+    }
+
+    this->file << "FRAME\n";
+    this->file.write(reinterpret_cast<const char*>(this->yuv.data()), this->yuv.size());
+}
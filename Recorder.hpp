@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+// Writes RGB frames on a worker thread, either as a raw YUV4MPEG2 stream or as a numbered PPM sequence in a folder
+class Recorder
+{
+public:
+    enum class Format
+    {
+        Y4M,
+        PPM
+    };
+
+    Recorder(const std::string& path, int width, int height, int fps, Format format = Format::Y4M);
+    ~Recorder();
+    Recorder(const Recorder&) = delete;
+    Recorder(Recorder&&) = delete;
+
+    // Blocks only when the worker is 'capacity' frames behind
+    auto push(std::vector<uint8_t> frame) -> void;
+    auto frames() const -> int;
+
+    static constexpr size_t capacity{ 64 };
+
+private:
+    auto work() -> void;
+    auto write(const std::vector<uint8_t>& frame) -> void;
+
+    std::string path{};
+    int width{ 0 };
+    int height{ 0 };
+    Format format{ Format::Y4M };
+    std::ofstream file{};
+    std::vector<uint8_t> yuv{};
+    std::atomic<int> written{ 0 };
+
+    std::deque<std::vector<uint8_t>> queue{};
+    std::mutex mutex{};
+    std::condition_variable condition{};
+    bool closing{ false };
+    std::thread worker{};
+};
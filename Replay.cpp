@@ -9,6 +9,7 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <filesystem>
 
 #include <box2d/box2d.h>
 #include <SDL_gpu.h>
@@ -16,13 +17,16 @@
 
 #include "Replay.hpp"
 #include "Draw.hpp"
+#include "Friction.hpp"
+#include "Simulation\Window.hpp"
 
-Replay::Replay(b2World* world, b2Body* ground, const b2Vec2& position, const std::string& filePath)
+Replay::Replay(b2World* world, b2Body* ground, const b2Vec2& position, const std::string& filePath, bool joint)
 {
     this->world = world;
     this->ground = ground;
     this->position = position;
     this->filePath = filePath;
+    this->joint = joint;
     this->openFile();
     this->createPath();
     this->createCar();
@@ -42,13 +46,102 @@ auto Replay::step() -> void
     this->stepSensor();
 }
 
-auto Replay::render(GPU_Target* target) -> void
+auto Replay::snapshot(Snapshot::Static& path, Snapshot::Body& car) const -> void
 {
-    GPU_SetLineThickness(0.01f);
+    path.bounds = this->bounds();
+    path.mesh = this->pathMesh;
 
-    this->renderPath(target);
-    this->renderCar(target);
-    this->renderSensor(target);
+    car.bounds = this->bounds();
+    car.transform = this->carBody->GetTransform();
+    car.shape = this->carShape;
+
+    // Crosshair at each recorded distance
+    car.beams.clear();
+    for (auto n{ 0 }; n < 6; ++n)
+    {
+        const auto radians{ static_cast<float>((this->sensors[n].first / 180.0) * M_PI) };
+        const auto end{ this->carBody->GetWorldPoint(this->sensors[n].second + b2Mul(b2Rot{ -radians }, b2Vec2{ 0.0f, this->current.distances[n] })) };
+
+        car.beams.emplace_back(b2Vec2{ end.x - 0.05f, end.y }, b2Vec2{ end.x + 0.05f, end.y });
+        car.beams.emplace_back(b2Vec2{ end.x, end.y - 0.05f }, b2Vec2{ end.x, end.y + 0.05f });
+    }
+}
+
+auto Replay::bounds() const -> b2AABB
+{
+    auto aabb{ b2AABB{} };
+    aabb.lowerBound = this->position;
+    aabb.upperBound = this->position + b2Vec2{ Replay::width, Replay::height };
+    return aabb;
+}
+
+auto Replay::isDone() const -> bool
+{
+    return not this->file.is_open();
+}
+
+auto Replay::line() const -> int
+{
+    return this->current.line;
+}
+
+auto Replay::angles() const -> std::array<int, 6>
+{
+    auto angles{ std::array<int, 6>{} };
+    for (auto n{ 0 }; n < angles.size(); ++n)
+    {
+        angles[n] = this->sensors[n].first;
+    }
+    return angles;
+}
+
+auto Replay::recorded() const -> std::array<float, 6>
+{
+    return this->current.distances;
+}
+
+auto Replay::simulated() const -> std::array<Sensor::Reading, 6>
+{
+    auto readings{ std::array<Sensor::Reading, 6>{} };
+    for (auto n{ 0 }; n < readings.size(); ++n)
+    {
+        const auto radians{ static_cast<float>((this->sensors[n].first / 180.0) * M_PI) };
+        readings[n] = Sensor::cast(this->world, this->carBody, this->sensors[n].second, radians);
+    }
+    return readings;
+}
+
+auto Replay::isCapture(const std::string& filePath) -> bool
+{
+    auto header{ std::string{} };
+
+    auto file{ std::ifstream{ filePath } };
+    if (file.is_open())
+    {
+        std::getline(file, header);
+    }
+
+    return header == Replay::header;
+}
+
+auto Replay::captures(const std::string& folderPath) -> std::vector<std::string>
+{
+    auto filePaths{ std::vector<std::string>{} };
+
+    if (std::filesystem::is_directory(folderPath))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator{ folderPath })
+        {
+            if (entry.is_regular_file() and entry.path().extension() == ".csv" and Replay::isCapture(entry.path().string()))
+            {
+                filePaths.emplace_back(entry.path().string());
+            }
+        }
+    }
+
+    std::sort(filePaths.begin(), filePaths.end());
+
+    return filePaths;
 }
 
 auto Replay::openFile() -> void
@@ -62,7 +155,7 @@ auto Replay::openFile() -> void
         std::getline(this->file, header);
     }
 
-    assert(header == "+33;+90;0;-33;-90;180;stop;forward;backward;left;right;");
+    assert(header == Replay::header);
 
     this->stepFile();
 }
@@ -73,15 +166,15 @@ auto Replay::createPath() -> void
         b2BodyDef bd{};
         bd.type = b2_staticBody;
         bd.position = b2Vec2{ this->position.x, this->position.y };
-        bd.userData = const_cast<char*>("maze");
+        bd.userData = Fixture::tag(Fixture::Kind::MAZE);
 
         this->pathBody = this->world->CreateBody(&bd);
     }
 
     { // Wall
         const auto thickness{ 0.015f };
-        const auto height{ 1.0f };
-        const auto width{ 1.5f };
+        const auto height{ Replay::height };
+        const auto width{ Replay::width };
         const auto segment{ 0.5f };
 
         b2PolygonShape shape{};
@@ -91,7 +184,7 @@ auto Replay::createPath() -> void
         fd.density = 0.0f;
         fd.filter.categoryBits = 0x0001;
         fd.filter.maskBits = 0x0003;
-        fd.userData = const_cast<char*>("wall");
+        fd.userData = Fixture::tag(Fixture::Kind::WALL);
         
         { // External
             
@@ -119,6 +212,8 @@ auto Replay::createPath() -> void
             this->pathBody->CreateFixture(&fd);
         }
     }
+
+    this->pathMesh = std::make_shared<const Draw::Mesh>(Draw::build(this->pathBody));
 }
 
 auto Replay::createCar() -> void
@@ -130,7 +225,7 @@ auto Replay::createCar() -> void
         bd.angle = b2_pi;
         bd.linearDamping = 0.1f;
         bd.angularDamping = 0.1f;
-        bd.userData = const_cast<char*>("car");
+        bd.userData = Fixture::tag(Fixture::Kind::CAR);
 
         this->carBody = this->world->CreateBody(&bd);
     }
@@ -145,7 +240,7 @@ auto Replay::createCar() -> void
         fd.filter.maskBits = 0x0001;
         fd.density = 10.0f;
         fd.friction = 0.1f;
-        fd.userData = const_cast<char*>("chassis");
+        fd.userData = Fixture::tag(Fixture::Kind::CHASSIS);
 
         this->carBody->CreateFixture(&fd);
     }
@@ -164,7 +259,7 @@ auto Replay::createCar() -> void
         fd.isSensor = true;
         fd.filter.categoryBits = 0x0002;
         fd.filter.maskBits = 0x0001;
-        fd.userData = const_cast<char*>("direction");
+        fd.userData = Fixture::tag(Fixture::Kind::DIRECTION);
 
         this->carBody->CreateFixture(&fd);
     }
@@ -178,65 +273,23 @@ auto Replay::createCar() -> void
             b2FixtureDef fd{};
             fd.shape = &polygon;
             fd.isSensor = true;
-            fd.userData = const_cast<char*>("sensor");
+            fd.userData = Fixture::tag(Fixture::Kind::SENSOR);
 
             this->carBody->CreateFixture(&fd);
         }
     }
 
+    if (this->joint)
     { // Top-down friction
-        const auto gravity{ 10.0f };
-        const auto inertia{ this->carBody->GetInertia() };
-        const auto mass{ this->carBody->GetMass() };
-        const auto radius{ b2Sqrt(2.0f * inertia / mass) };
-
-        b2FrictionJointDef jd{};
-        jd.bodyA = this->ground;
-        jd.bodyB = this->carBody;
-        jd.localAnchorA = b2Vec2{ 0.0f, 0.0f };
-        jd.localAnchorB = this->carBody->GetLocalCenter();
-        jd.collideConnected = true;
-        jd.maxForce = 0.1f * mass * gravity;
-        jd.maxTorque = 0.1f * mass * radius * gravity;
-        jd.userData = const_cast<char*>("friction");
-
-        this->world->CreateJoint(&jd);
+        Friction::joint(this->world, this->ground, this->carBody);
     }
-}
 
-auto Replay::createSensor() -> void
-{
-
-}
-
-auto Replay::renderPath(GPU_Target* target) -> void
-{
-    Draw::draw(target, this->pathBody);
+    this->carShape = std::make_shared<const Draw::Mesh>(Draw::shape(this->carBody));
 }
 
-auto Replay::renderCar(GPU_Target* target) -> void
-{
-    Draw::draw(target, this->carBody);
-}
-
-auto Replay::renderSensor(GPU_Target* target) -> void
+auto Replay::createSensor() -> void
 {
-    b2Filter filter{};
-    filter.categoryBits = 0x0002;
-    filter.maskBits = 0x0001;
 
-    for(auto n{ 0 }; n < 6; ++n)
-    {
-        const auto radians{ static_cast<float>((this->sensors[n].first / 180.0) * M_PI) };
-
-        const auto start{ this->carBody->GetWorldPoint(this->sensors[n].second)};
-        const auto end{ this->carBody->GetWorldPoint(this->sensors[n].second + b2Mul(b2Rot{ -radians }, b2Vec2{ 0.0f, this->current.distances[n] }))};
-
-        // Crosshair
-        static constexpr SDL_Color sensorColor{ 0,0,255,255 };
-        GPU_Line(target, end.x - 0.05f, end.y, end.x + 0.05f, end.y, sensorColor);
-        GPU_Line(target, end.x, end.y - 0.05f, end.x, end.y + 0.05f, sensorColor);
-    }
 }
 
 auto Replay::stepFile() -> void
@@ -261,7 +314,7 @@ auto Replay::stepFile() -> void
             >> moves[3] >> separator
             >> moves[4] >> separator;
 
-        if (file.eof())
+        if (file.eof() or file.fail())
         {
             file.close();
         }
@@ -312,6 +365,11 @@ auto Replay::stepCar() -> void
         this->carBody->SetLinearVelocity(point);
     }
 
+    if (not this->joint)
+    {
+        Friction::apply(this->carBody, Window::timeStep);
+    }
+
     this->current.move = Move::STOP;
 }
 
@@ -8,17 +8,36 @@
 #include <array>
 #include <iostream>
 #include <fstream>
+#include <memory>
+
+#include "Sensor.hpp"
+#include "Draw.hpp"
+#include "Simulation\Snapshot.hpp"
 
 class Replay
 {
 public:
-    Replay(b2World* world, b2Body* ground, const b2Vec2& position, const std::string& filePath);
+    // Without the joint the car friction is applied to its velocities directly, see Friction::apply
+    Replay(b2World* world, b2Body* ground, const b2Vec2& position, const std::string& filePath, bool joint = true);
     ~Replay();
     Replay(const Replay&) = delete;
     Replay(Replay&&) = delete;
 
     auto step() -> void;
-    auto render(GPU_Target* target) -> void;
+    auto snapshot(Snapshot::Static& path, Snapshot::Body& car) const -> void;
+    auto bounds() const -> b2AABB;
+    auto isDone() const -> bool;
+
+    auto line() const -> int;
+    auto angles() const -> std::array<int, 6>;
+    auto recorded() const -> std::array<float, 6>;
+    auto simulated() const -> std::array<Sensor::Reading, 6>;
+
+    static auto isCapture(const std::string& filePath) -> bool;
+    static auto captures(const std::string& folderPath) -> std::vector<std::string>;
+
+    static constexpr float width{ 1.5f };
+    static constexpr float height{ 1.0f };
 private:
 
     enum class Move
@@ -41,9 +60,12 @@ private:
     b2Body* ground{ nullptr };
     b2Vec2 position{};
     std::string filePath{};
+    bool joint{ true };
 
     b2Body* pathBody{ nullptr };
+    std::shared_ptr<const Draw::Mesh> pathMesh{};
     b2Body* carBody{ nullptr };
+    std::shared_ptr<const Draw::Mesh> carShape{};
     std::ifstream file{};
     Entry current{};
 
@@ -56,15 +78,13 @@ private:
         {180, {0.000f, -0.128f}}
     } };
 
+    static constexpr auto header{ "+33;+90;0;-33;-90;180;stop;forward;backward;left;right;" };
+
     auto openFile() -> void;
     auto createPath() -> void;
     auto createCar() -> void;
     auto createSensor() -> void;
 
-    auto renderPath(GPU_Target* target) -> void;
-    auto renderCar(GPU_Target* target) -> void;
-    auto renderSensor(GPU_Target* target) -> void;
-
     auto stepFile() -> void;
     auto stepPath() -> void;
     auto stepCar() -> void;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <box2d/box2d.h>
+
+#include "Fixture.hpp"
+
+namespace Sensor
+{
+    // Reports the closest fixture of the given kind, ignoring everything else along the beam
+    class RayCastCallback : public b2RayCastCallback
+    {
+    public:
+        RayCastCallback(Fixture::Kind kind)
+        {
+            this->kind = kind;
+        }
+
+        float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override
+        {
+            if (Fixture::kind(fixture) == this->kind)
+            {
+                this->valid = true;
+                this->point = point;
+                this->normal = normal;
+                return fraction;
+            }
+
+            return -1;
+        }
+
+        Fixture::Kind kind{ Fixture::Kind::WALL };
+        bool valid{ false };
+        b2Vec2 point{ 0.0, 0.0 };
+        b2Vec2 normal{ 0.0, 0.0 };
+    };
+
+    struct Reading
+    {
+        bool valid;
+        float distance;
+        float incidence;
+    };
+
+    static constexpr float maxDistance{ 2.0f };
+
+    // Casts the beam of a sensor mounted at 'position' (body coordinates) pointing 'radians' away from the car front
+    static auto cast(const b2World* world, const b2Body* body, const b2Vec2& position, float radians, float maxDistance = Sensor::maxDistance) -> Reading
+    {
+        const auto start{ body->GetWorldPoint(position) };
+        const auto end{ body->GetWorldPoint(position + b2Mul(b2Rot{ -radians }, b2Vec2{ 0.0f, maxDistance })) };
+
+        auto callback{ RayCastCallback{ Fixture::Kind::WALL } };
+        world->RayCast(&callback, start, end);
+        if (not callback.valid)
+        {
+            return Reading{ false, maxDistance, 0.0f };
+        }
+
+        auto direction{ end - start };
+        direction.Normalize();
+
+        const auto cosine{ std::clamp(-b2Dot(direction, callback.normal), -1.0f, 1.0f) };
+
+        return Reading{ true, b2Distance(start, callback.point), std::acos(cosine) };
+    }
+}
@@ -7,39 +7,18 @@
 #include <array>
 
 #include <box2d/box2d.h>
+#include <box2d/b2_time_of_impact.h>
 #include <SDL_gpu.h>
 #include <SDL_FontCache.h>
 
 #include "car.hpp"
 #include "..\Draw.hpp"
+#include "..\Sensor.hpp"
+#include "..\Profiler.hpp"
+#include "..\Friction.hpp"
+#include "Window.hpp"
 
-class RayCastCallback : public b2RayCastCallback
-{
-public:
-    RayCastCallback(b2Filter* filter)
-    {
-        this->filter = filter;
-    }
-
-    float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override
-    {
-        const auto filter{ fixture->GetFilterData() };
-        if ((this->filter->maskBits & filter.categoryBits) != 0 and (filter.maskBits & this->filter->categoryBits) != 0)
-        {
-            this->valid = true;
-            this->point = point;
-            return fraction;
-        }
-
-        return -1;
-    }
-
-    b2Filter* filter{ nullptr };
-    bool valid{ false };
-    b2Vec2 point{ 0.0, 0.0 };
-};
-
-Car::Car(b2World* world, b2Body* ground, const b2Vec2& position)
+Car::Car(b2World* world, b2Body* ground, const b2Vec2& position, const Noise* noise, Dynamics dynamics)
 {
     //this->sensors.clear();
 
@@ -57,12 +36,15 @@ Car::Car(b2World* world, b2Body* ground, const b2Vec2& position)
 
     this->world = world;
     this->ground = ground;
+    this->noise = noise;
+    this->dynamics = dynamics;
     this->createBody(position);
     this->step();
 }
 
-Car::Car(const Car& other) : Car{ other.world, other.ground, other.body->GetPosition() }
+Car::Car(const Car& other) : Car{ other.world, other.ground, other.body->GetPosition(), other.noise, other.dynamics }
 {
+    this->mt = other.mt;
 }
 
 Car::~Car()
@@ -74,12 +56,12 @@ auto Car::createBody(const b2Vec2& position) -> void
 {
     { // Body
         b2BodyDef bd{};
-        bd.type = b2_dynamicBody;
+        bd.type = this->dynamics == Dynamics::KINEMATIC ? b2_kinematicBody : b2_dynamicBody;
         bd.position = position;
         bd.angle = b2_pi;
         bd.linearDamping = 0.1f;
         bd.angularDamping = 0.1f;
-        bd.userData = const_cast<char*>("car");
+        bd.userData = Fixture::tag(Fixture::Kind::CAR);
 
         this->body = this->world->CreateBody(&bd);
     }
@@ -94,9 +76,9 @@ auto Car::createBody(const b2Vec2& position) -> void
         fd.filter.maskBits = 0x0001;
         fd.density = 10.0f;
         fd.friction = 0.1f;
-        fd.userData = const_cast<char*>("chassis");
+        fd.userData = Fixture::tag(Fixture::Kind::CHASSIS);
 
-        this->body->CreateFixture(&fd);
+        this->hull = this->body->CreateFixture(&fd);
     }
 
     { // Direction symbol (triangle)
@@ -113,7 +95,7 @@ auto Car::createBody(const b2Vec2& position) -> void
         fd.isSensor = true;
         fd.filter.categoryBits = 0x0002;
         fd.filter.maskBits = 0x0001;
-        fd.userData = const_cast<char*>("chassis");
+        fd.userData = Fixture::tag(Fixture::Kind::CHASSIS);
     
         this->body->CreateFixture(&fd);
     }
@@ -129,34 +111,25 @@ auto Car::createBody(const b2Vec2& position) -> void
             fd.isSensor = true;
             fd.filter.categoryBits = 0x0002;
             fd.filter.maskBits = 0x0001;
-            fd.userData = const_cast<char*>("sensor");
+            fd.userData = Fixture::tag(Fixture::Kind::SENSOR);
     
             this->body->CreateFixture(&fd);
         }
     }
 
-    { // Top-down friction
-        const auto gravity{ 10.0f };
-        const auto inertia{ this->body->GetInertia() };
-        const auto mass{ this->body->GetMass() };
-        const auto radius{ b2Sqrt(2.0f * inertia / mass) };
-
-        b2FrictionJointDef jd{};
-        jd.bodyA = this->ground;
-        jd.bodyB = this->body;
-        jd.localAnchorA = b2Vec2{ 0.0f, 0.0f };
-        jd.localAnchorB = this->body->GetLocalCenter();
-        jd.collideConnected = true;
-        jd.maxForce = 0.1f * mass * gravity;
-        jd.maxTorque = 0.1f * mass * radius * gravity;
-        jd.userData = const_cast<char*>("friction");
-
-        this->world->CreateJoint(&jd);
+    // Top-down friction, kinematic bodies ignore forces and DIRECT applies it in stepBody
+    if (this->dynamics == Dynamics::DYNAMIC)
+    {
+        Friction::joint(this->world, this->ground, this->body);
     }
+
+    this->shape = std::make_shared<const Draw::Mesh>(Draw::shape(this->body));
 }
 
 auto Car::step() -> void
 {
+    const auto scope{ Profiler::Scope{ Profiler::Phase::CAR } };
+
     /*
     for (auto&& [angle, distance] : this->sensors)
     {
@@ -169,15 +142,65 @@ auto Car::step() -> void
 
  }
 
-auto Car::render(GPU_Target* target) -> void
+auto Car::sense() -> void
+{
+    const auto scope{ Profiler::Scope{ Profiler::Phase::SENSE } };
+
+    for (auto&& [angle, position, distance] : sensors)
+    {
+        const auto radians{ (angle / 180.0f) * b2_pi };
+        stepSensor(position, &distance, radians);
+    }
+}
+
+// Keeps the pose for drawing but leaves the world: no broadphase proxies, no island, no contacts
+auto Car::finish() -> void
+{
+    this->body->SetEnabled(false);
+}
+
+// Back to how the constructor leaves it, reusing the body and its fixtures
+auto Car::reset(const b2Vec2& position) -> void
 {
-    GPU_SetLineThickness(0.01f);
+    this->body->SetEnabled(true);
+    this->body->SetTransform(position, b2_pi);
+    this->body->SetLinearVelocity(b2Vec2{ 0.0f, 0.0f });
+    this->body->SetAngularVelocity(0.0f);
+
+    for (auto& sensor : this->sensors)
+    {
+        std::get<2>(sensor) = 0.0f;
+    }
+
+    this->ready = true;
+    this->stuck = false;
+    this->blocked = false;
+    this->hits = 0;
+    this->move = Move::STOP;
+    this->requested.clear();
+
+    this->step();
+}
+
+// The sensor noise of a seeded episode then repeats with its maze
+auto Car::seed(uint32_t seed) -> void
+{
+    this->mt.seed(seed);
+}
+
+auto Car::snapshot(Snapshot::Body& snapshot) const -> void
+{
+    snapshot.transform = this->body->GetTransform();
+    snapshot.shape = this->shape;
 
-    renderBody(target);
+    snapshot.beams.clear();
     for (auto&& [angle, position, distance] : sensors)
     {
         const auto radians{ (angle / 180.0f) * b2_pi };
-        renderSensor(target, position, &distance, radians);
+
+        const auto start{ this->body->GetWorldPoint(position) };
+        const auto end{ this->body->GetWorldPoint(position + b2Mul(b2Rot{ -radians }, b2Vec2{ 0.0f, distance })) };
+        snapshot.beams.emplace_back(start, end);
     }
 }
 
@@ -220,6 +243,36 @@ auto Car::distances() const -> std::array<std::pair<int, float>, 18>
     return distances;
 }
 
+auto Car::inputs() const -> std::vector<float>
+{
+    auto inputs{ std::vector<float>{} };
+
+    const auto distances{ this->distances() };
+    for (auto [angle, distance] : distances)
+    {
+        inputs.emplace_back(distance);
+    }
+
+    //const auto color{ static_cast<int>(this->color()) };
+    //{
+    //    inputs.emplace_back(color);
+    //}
+
+    //const auto giroscope{ this->giroscope() };
+    //for (auto& value : giroscope)
+    //{
+    //    inputs.emplace_back(value);
+    //}
+    //
+    //const auto acelerometer{ this->acelerometer() };
+    //for (auto& value : acelerometer)
+    //{
+    //    inputs.emplace_back(value);
+    //}
+
+    return inputs;
+}
+
 auto Car::color() const -> Color
 {
     return Color::BLACK;
@@ -237,6 +290,33 @@ auto Car::acelerometer() const->std::vector<float>
 
 auto Car::stepBody() -> void
 {
+    if (this->dynamics == Dynamics::KINEMATIC)
+    {
+        auto velocity{ b2Vec2{ 0.0f, 0.0f } };
+        auto angularVelocity{ 0.0f };
+
+        if (this->move == Move::ROTATE_LEFT)
+        {
+            angularVelocity = -4.0f;
+        }
+        else if (this->move == Move::ROTATE_RIGHT)
+        {
+            angularVelocity = +4.0f;
+        }
+        else if (this->move == Move::MOVE_FORWARD)
+        {
+            velocity = this->body->GetWorldVector(b2Vec2{ 0.0f, +1.0f });
+        }
+        else if (this->move == Move::MOVE_BACKWARD)
+        {
+            velocity = this->body->GetWorldVector(b2Vec2{ 0.0f, -1.0f });
+        }
+
+        this->stepKinematic(velocity, angularVelocity);
+        this->move = Move::STOP;
+        return;
+    }
+
     this->body->SetAngularVelocity(0.0f);
     this->body->SetLinearVelocity({ 0.0f,0.0f });
 
@@ -259,54 +339,148 @@ auto Car::stepBody() -> void
         this->body->SetLinearVelocity(point);
     }
 
+    if (this->dynamics == Dynamics::DIRECT)
+    {
+        Friction::apply(this->body, Window::timeStep);
+    }
+
     this->move = Move::STOP;
 }
 
-auto Car::stepSensor(const b2Vec2& position, float* distance, float angle) -> void
+// Clamps the motion of the next world step to what the walls allow, sliding along the first one hit, and lets Box2D integrate it
+auto Car::stepKinematic(const b2Vec2& velocity, float angularVelocity) -> void
 {
-    b2Filter filter{};
-    filter.categoryBits = 0x0002;
-    filter.maskBits = 0x0001;
+    auto translation{ Window::timeStep * velocity };
+    auto rotation{ Window::timeStep * angularVelocity };
 
-    const auto maxDistance{ 2.0f };
-    const auto start{ this->body->GetWorldPoint(position) };
-    const auto end{ this->body->GetWorldPoint(position + b2Mul(b2Rot{ -angle }, b2Vec2{ 0.0f, maxDistance })) };
+    const auto position{ this->body->GetPosition() };
+    const auto angle{ this->body->GetAngle() };
 
-    auto rd{ std::random_device{} };
-    auto mt{ std::mt19937{rd()} };
-
-    auto callback{ RayCastCallback{&filter} };
-    this->world->RayCast(&callback, start, end);
-    if (callback.valid)
+    auto normal{ b2Vec2{ 0.0f, 0.0f } };
+    const auto fraction{ this->sweep(position, angle, translation, rotation, &normal) };
+    if (fraction < 1.0f)
     {
-        auto dist{ std::uniform_real_distribution{ -0.03f, +0.03f } };
-        const auto noise{ dist(mt) };
+        auto remaining{ (1.0f - fraction) * translation };
+        translation *= fraction;
+        rotation *= fraction;
 
-        const auto measuredDistance{ b2Distance(start, callback.point) };
-        *distance = std::clamp(measuredDistance + noise, 0.0f, 2.0f);
+        const auto into{ b2Dot(remaining, normal) };
+        if (into < 0.0f)
+        {
+            remaining -= into * normal;
+        }
+
+        translation += this->sweep(position + translation, angle + rotation, remaining, 0.0f, &normal) * remaining;
+
+        this->hits += this->blocked ? 0 : 1;
     }
-}
+    this->blocked = fraction < 1.0f;
 
-auto Car::renderBody(GPU_Target* target) const -> void
-{
-    Draw::draw(target, this->body);
+    this->body->SetLinearVelocity((1.0f / Window::timeStep) * translation);
+    this->body->SetAngularVelocity(rotation / Window::timeStep);
 }
 
-auto Car::renderSensor(GPU_Target* target, const b2Vec2& position, float* distance, float radians) -> void
+// Fraction of the motion from the given pose before the hull touches a wall, and that wall's normal (pointing at the car)
+// Only reads the world's fixtures, so cars sharing one can sweep concurrently. b2TimeOfImpact and b2Distance still bump
+// Box2D's global b2_toiCalls / b2_gjkCalls statistics unsynchronised, a race on those counters alone that nothing here reads
+auto Car::sweep(const b2Vec2& position, float angle, const b2Vec2& translation, float rotation, b2Vec2* normal) const -> float
 {
-    this->stepSensor(position, distance, radians);
+    const auto& shape{ *static_cast<const b2PolygonShape*>(this->hull->GetShape()) };
+
+    auto sweepA{ b2Sweep{} };
+    sweepA.localCenter = b2Vec2{ 0.0f, 0.0f };
+    sweepA.c0 = position;
+    sweepA.c = position + translation;
+    sweepA.a0 = angle;
+    sweepA.a = angle + rotation;
+    sweepA.alpha0 = 0.0f;
+
+    auto transform{ b2Transform{} }, end{ b2Transform{} };
+    sweepA.GetTransform(&transform, 0.0f);
+    sweepA.GetTransform(&end, 1.0f);
+
+    auto bounds{ b2AABB{} }, other{ b2AABB{} };
+    shape.ComputeAABB(&bounds, transform, 0);
+    shape.ComputeAABB(&other, end, 0);
+    bounds.Combine(other);
+
+    class Query : public b2QueryCallback
+    {
+    public:
+        bool ReportFixture(b2Fixture* fixture) override
+        {
+            if (Fixture::kind(fixture) == Fixture::Kind::WALL)
+            {
+                this->walls.emplace_back(fixture);
+            }
+            return true;
+        }
+
+        std::vector<const b2Fixture*> walls{};
+    };
+
+    auto query{ Query{} };
+    this->world->QueryAABB(&query, bounds);
 
-    const auto start{ this->body->GetWorldPoint(position) };
-    const auto end{ this->body->GetWorldPoint(position + b2Mul(b2Rot{ -radians }, b2Vec2{ 0.0f, *distance })) };
+    auto fraction{ 1.0f };
+    for (const auto wall : query.walls)
+    {
+        const auto wallBody{ wall->GetBody() };
+
+        auto input{ b2TOIInput{} };
+        input.proxyA.Set(&shape, 0);
+        input.proxyB.Set(wall->GetShape(), 0);
+        input.sweepA = sweepA;
+        input.sweepB.localCenter = b2Vec2{ 0.0f, 0.0f };
+        input.sweepB.c0 = input.sweepB.c = wallBody->GetPosition();
+        input.sweepB.a0 = input.sweepB.a = wallBody->GetAngle();
+        input.sweepB.alpha0 = 0.0f;
+        input.tMax = 1.0f;
+
+        auto output{ b2TOIOutput{} };
+        b2TimeOfImpact(&output, &input);
+
+        // Already overlapping walls are ignored, so a car pushed inside one can still drive out
+        if (output.state == b2TOIOutput::e_touching and output.t < fraction)
+        {
+            fraction = output.t;
 
-    // Crosshair
-    //GPU_Line(target, end.x - 0.05f, end.y, end.x + 0.05f, end.y, sensorColor);
-    //GPU_Line(target, end.x, end.y - 0.05f, end.x, end.y + 0.05f, sensorColor);
+            auto distanceInput{ b2DistanceInput{} };
+            distanceInput.proxyA = input.proxyA;
+            distanceInput.proxyB = input.proxyB;
+            input.sweepA.GetTransform(&distanceInput.transformA, output.t);
+            distanceInput.transformB = wallBody->GetTransform();
+            distanceInput.useRadii = false;
 
-    // Line
-    GPU_Line(target, start.x, start.y, end.x, end.y, sensorColor);
+            auto cache{ b2SimplexCache{} };
+            auto distanceOutput{ b2DistanceOutput{} };
+            b2Distance(&distanceOutput, &cache, &distanceInput);
+
+            *normal = distanceOutput.pointA - distanceOutput.pointB;
+            normal->Normalize();
+        }
+    }
+
+    return fraction;
 }
 
+auto Car::stepSensor(const b2Vec2& position, float* distance, float angle) -> void
+{
+    const auto reading{ Sensor::cast(this->world, this->body, position, angle, Car::maxDistance) };
+    const auto degrees{ static_cast<int>(std::round(angle / b2_pi * 180.0f)) };
+    if (reading.valid and this->noise != nullptr and this->noise->contains(degrees))
+    {
+        const auto measuredDistance{ this->noise->sample(degrees, reading.distance, reading.incidence, this->mt) };
+        *distance = std::clamp(measuredDistance, 0.0f, Car::maxDistance);
+    }
+    else if (reading.valid)
+    {
+        auto dist{ std::uniform_real_distribution{ -0.03f, +0.03f } };
+        const auto noise{ dist(this->mt) };
+
+        *distance = std::clamp(reading.distance + noise, 0.0f, Car::maxDistance);
+    }
+}
 
 auto Car::linearVelocity() const -> float
 {
@@ -316,4 +490,23 @@ auto Car::linearVelocity() const -> float
 auto Car::angularVelocity() const -> float
 {
     return this->body->GetAngularVelocity();
+}
+
+auto Car::contacts() const -> int
+{
+    return this->hits;
+}
+
+auto Car::decide(const std::vector<float>& outputs) -> Move
+{
+    auto max{ 0 };
+    for (auto n{ 1 }; n < outputs.size(); ++n)
+    {
+        if (std::abs(outputs[n]) > std::abs(outputs[max]))
+        {
+            max = n;
+        }
+    }
+
+    return static_cast<Move>(max);
 }
\ No newline at end of file
@@ -6,6 +6,12 @@
 #include <map>
 #include <deque>
 #include <array>
+#include <memory>
+#include <random>
+
+#include "..\Noise.hpp"
+#include "..\Draw.hpp"
+#include "Snapshot.hpp"
 
 enum class Move
 {
@@ -31,11 +37,25 @@ enum class Color
 class Car
 {
 public:
-    Car(b2World* world, b2Body* ground, const b2Vec2& position = {});
+    // DYNAMIC lets Box2D solve the car like any other body, with a friction joint to the ground
+    // DIRECT drops the joint and takes the same friction off the commanded velocities, so each car is its own island
+    // KINEMATIC moves it directly and stops it at the walls with a swept test
+    enum class Dynamics
+    {
+        DYNAMIC,
+        DIRECT,
+        KINEMATIC
+    };
+
+    Car(b2World* world, b2Body* ground, const b2Vec2& position = {}, const Noise* noise = nullptr, Dynamics dynamics = Dynamics::DYNAMIC);
     Car(const Car& other);
     ~Car();
     auto step() -> void;
-    auto render(GPU_Target* target) -> void;
+    auto sense() -> void;
+    auto finish() -> void;
+    auto reset(const b2Vec2& position) -> void;
+    auto seed(uint32_t seed) -> void;
+    auto snapshot(Snapshot::Body& snapshot) const -> void;
 
     auto position() const->b2Vec2;
     auto angle() const->float;
@@ -45,22 +65,31 @@ public:
     auto doMove(Move move) -> void;
 
     auto distances() const->std::array<std::pair<int, float>, 18>;
+    auto inputs() const->std::vector<float>;
     auto color() const ->Color;
     auto giroscope() const -> std::vector<float>;
     auto acelerometer() const ->std::vector<float>;
     auto linearVelocity() const -> float;
     auto angularVelocity() const -> float;
+    auto contacts() const -> int;
+
+    static auto decide(const std::vector<float>& outputs)->Move;
 
 private:
     auto createBody(const b2Vec2& position) -> void;
     auto stepBody() -> void;
+    auto stepKinematic(const b2Vec2& velocity, float angularVelocity) -> void;
+    auto sweep(const b2Vec2& position, float angle, const b2Vec2& translation, float rotation, b2Vec2* normal) const -> float;
     auto stepSensor(const b2Vec2& position, float* distance, float angle) -> void;
-    auto renderBody(GPU_Target* target) const -> void;
-    auto renderSensor(GPU_Target* target, const b2Vec2& position, float* distance, float radians) -> void;
 
     b2World* world{ nullptr };
     b2Body* ground{ nullptr };
     b2Body* body{ nullptr };
+    const Noise* noise{ nullptr };
+    Dynamics dynamics{ Dynamics::DYNAMIC };
+    std::mt19937 mt{ std::random_device{}() }; // sensor noise, seeded by an episode that has to be reproduced
+    const b2Fixture* hull{ nullptr };
+    std::shared_ptr<const Draw::Mesh> shape{};
 
     std::array<std::tuple<int, b2Vec2, float>, 18> sensors{ {
         {+33, {0.056f, 0.114f}, 0.0f},
@@ -90,6 +119,8 @@ private:
 
     bool ready{ true };
     bool stuck{ false };
+    bool blocked{ false };
+    int hits{ 0 };
     Move move{ Move::STOP };
     std::map<int, float> requested{};
 
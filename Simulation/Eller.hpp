@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// Eller's algorithm, one row at a time: only the set of every cell of the current row is kept,
+// so a maze of any height is carved in memory proportional to its width.
+// After each advance, right(x) and down(x) tell which walls of the row just produced are open.
+class Eller
+{
+public:
+    Eller(size_t columns, uint32_t seed)
+    {
+        this->width = columns;
+        this->mt.seed(seed);
+        this->sets.resize(columns, Eller::none);
+        this->parents.resize(columns);
+        this->sizes.resize(columns);
+        this->used.resize(columns);
+        this->descended.resize(columns);
+        this->openRight.resize(columns);
+        this->openDown.resize(columns);
+    }
+
+    // Carves the next row, the last one joins every set left so the maze stays connected
+    auto advance(bool last) -> void
+    {
+        this->label();
+
+        auto coin{ std::bernoulli_distribution{ 0.5 } };
+
+        for (auto x{ size_t{ 0 } }; x + 1 < this->width; ++x)
+        {
+            const auto a{ this->find(this->sets[x]) };
+            const auto b{ this->find(this->sets[x + 1]) };
+            this->openRight[x] = a != b and (last or coin(this->mt));
+            if (this->openRight[x])
+            {
+                this->parents[b] = a;
+            }
+        }
+        this->openRight[this->width - 1] = false;
+
+        for (auto x{ size_t{ 0 } }; x < this->width; ++x)
+        {
+            this->sets[x] = this->find(this->sets[x]);
+            this->sizes[this->sets[x]] = 0;
+            this->descended[this->sets[x]] = false;
+        }
+        for (auto x{ size_t{ 0 } }; x < this->width; ++x)
+        {
+            ++this->sizes[this->sets[x]];
+        }
+
+        // Every set goes down at least once, through its last cell if no coin chose an earlier one
+        for (auto x{ size_t{ 0 } }; x < this->width; ++x)
+        {
+            const auto set{ this->sets[x] };
+            --this->sizes[set];
+
+            this->openDown[x] = not last and (coin(this->mt) or (this->sizes[set] == 0 and not this->descended[set]));
+            if (this->openDown[x])
+            {
+                this->descended[set] = true;
+            }
+        }
+
+        for (auto x{ size_t{ 0 } }; x < this->width; ++x)
+        {
+            if (not this->openDown[x])
+            {
+                this->sets[x] = Eller::none;
+            }
+        }
+    }
+
+    auto right(size_t x) const -> bool
+    {
+        return this->openRight[x];
+    }
+
+    auto down(size_t x) const -> bool
+    {
+        return this->openDown[x];
+    }
+
+private:
+    // Compacts the labels carried down and hands the unused ones to the new cells
+    auto label() -> void
+    {
+        std::fill(this->used.begin(), this->used.end(), false);
+        for (const auto set : this->sets)
+        {
+            if (set != Eller::none)
+            {
+                this->used[set] = true;
+            }
+        }
+
+        auto free{ size_t{ 0 } };
+        for (auto& set : this->sets)
+        {
+            if (set == Eller::none)
+            {
+                while (this->used[free])
+                {
+                    ++free;
+                }
+                set = static_cast<uint32_t>(free);
+                this->used[free] = true;
+            }
+        }
+
+        for (auto n{ size_t{ 0 } }; n < this->width; ++n)
+        {
+            this->parents[n] = static_cast<uint32_t>(n);
+        }
+    }
+
+    auto find(uint32_t set) -> uint32_t
+    {
+        while (this->parents[set] != set)
+        {
+            this->parents[set] = this->parents[this->parents[set]];
+            set = this->parents[set];
+        }
+        return set;
+    }
+
+    static constexpr uint32_t none{ UINT32_MAX };
+
+    size_t width{ 0 };
+    std::mt19937 mt{};
+    std::vector<uint32_t> sets{};
+    std::vector<uint32_t> parents{};
+    std::vector<uint32_t> sizes{};
+    std::vector<bool> used{};
+    std::vector<bool> descended{};
+    std::vector<bool> openRight{};
+    std::vector<bool> openDown{};
+};
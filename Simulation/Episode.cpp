@@ -0,0 +1,141 @@
+#include <algorithm>
+
+#include "Episode.hpp"
+#include "Window.hpp"
+#include "Follower.hpp"
+#include "..\Fixture.hpp"
+
+Episode::Episode(const Noise* noise, std::optional<uint32_t> seed, Car::Dynamics dynamics, const Quality::Profile& quality, Maze::Layout layout, Maze::Generator generator)
+{
+    this->quality = &quality;
+    this->world.SetContactListener(this);
+
+    b2BodyDef bd{};
+    bd.userData = Fixture::tag(Fixture::Kind::GROUND);
+    this->ground = this->world.CreateBody(&bd);
+
+    this->maze = std::make_unique<Maze>(&world, ground, 3, 3, 0.0f, 0.0f, 1.5f, 1.5f, layout);
+    this->maze->randomize(seed, generator);
+
+    this->car = std::make_unique<Car>(&world, ground, this->maze->startPoint(), noise, dynamics);
+    if (seed.has_value())
+    {
+        this->car->seed(*seed);
+    }
+    this->begin();
+}
+
+// A new maze on the same world, with the car moved back instead of rebuilt
+auto Episode::reset(std::optional<uint32_t> seed, Maze::Generator generator) -> void
+{
+    this->maze->randomize(seed, generator);
+    this->car->reset(this->maze->startPoint());
+    if (seed.has_value())
+    {
+        this->car->seed(*seed);
+    }
+    this->begin();
+}
+
+auto Episode::begin() -> void
+{
+    this->car->sense();
+    this->follower = std::make_unique<Follower>(this->car.get(), this->maze->solve(this->car->position(), true));
+
+    this->tick = 0;
+    this->touches = 0;
+    this->startDistance = this->maze->distance(this->car->position());
+    this->bestDistance = this->startDistance;
+}
+
+auto Episode::step(Move move) -> void
+{
+    if (this->isDone())
+    {
+        return;
+    }
+
+    this->car->doMove(move);
+    this->car->step();
+
+    Quality::step(this->world, *this->quality);
+    ++this->tick;
+
+    this->car->sense();
+    this->bestDistance = std::min(this->bestDistance, this->maze->distance(this->car->position()));
+}
+
+auto Episode::inputs() const->std::vector<float>
+{
+    return this->car->inputs();
+}
+
+// What the path follower would do from here, the same expert DAGGER labels with.
+// It lives through the episode, and is only planned again once another driver has left the car off its path
+auto Episode::expert() -> Move
+{
+    if (this->follower->isDone() or not this->follower->isOnPath(*this->maze))
+    {
+        this->follower = std::make_unique<Follower>(this->car.get(), this->maze->solve(this->car->position(), true));
+    }
+    return this->follower->expert();
+}
+
+auto Episode::isDone() const -> bool
+{
+    return this->maze->isOnEnd(this->car->position());
+}
+
+auto Episode::ticks() const -> int
+{
+    return this->tick;
+}
+
+// Measured along the corridors, so a car parked behind the wall next to the exit gets no credit for it
+auto Episode::progress() const -> float
+{
+    if (this->startDistance <= 0.0f)
+    {
+        return 1.0f;
+    }
+    return std::clamp(1.0f - this->bestDistance / this->startDistance, 0.0f, 1.0f);
+}
+
+// Kinematic cars never touch the walls through Box2D, they count their own swept hits instead
+auto Episode::collisions() const -> int
+{
+    return this->touches + this->car->contacts();
+}
+
+// Counts the chassis touching a wall, once per new contact
+auto Episode::BeginContact(b2Contact* contact) -> void
+{
+    if (contact->GetFixtureA()->IsSensor() or contact->GetFixtureB()->IsSensor())
+    {
+        return;
+    }
+
+    const auto first{ Fixture::kind(contact->GetFixtureA()) };
+    const auto second{ Fixture::kind(contact->GetFixtureB()) };
+    if ((first == Fixture::Kind::CHASSIS and second == Fixture::Kind::WALL) or (first == Fixture::Kind::WALL and second == Fixture::Kind::CHASSIS))
+    {
+        ++this->touches;
+    }
+}
+
+auto Episode::bounds() const -> b2AABB
+{
+    return this->maze->bounds();
+}
+
+auto Episode::snapshot(Snapshot& snapshot) const -> void
+{
+    snapshot.paths.clear();
+
+    snapshot.statics.resize(1);
+    this->maze->snapshot(snapshot.statics[0]);
+
+    snapshot.bodies.resize(1);
+    snapshot.bodies[0].bounds = this->maze->bounds();
+    this->car->snapshot(snapshot.bodies[0]);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <box2d/box2d.h>
+
+#include "Maze.hpp"
+#include "Car.hpp"
+#include "Follower.hpp"
+#include "Snapshot.hpp"
+#include "Quality.hpp"
+
+// Headless single car run on its own world, so episodes can be stepped concurrently
+// Resetting keeps the world, so the chunks its block allocator already holds serve every following episode
+class Episode : private b2ContactListener
+{
+public:
+    Episode(const Noise* noise = nullptr, std::optional<uint32_t> seed = std::nullopt, Car::Dynamics dynamics = Car::Dynamics::DYNAMIC, const Quality::Profile& quality = Quality::standard, Maze::Layout layout = Maze::Layout::FIXED, Maze::Generator generator = Maze::Generator::BACKTRACKER);
+    Episode(const Episode&) = delete;
+    Episode(Episode&&) = delete;
+
+    auto reset(std::optional<uint32_t> seed = std::nullopt, Maze::Generator generator = Maze::Generator::BACKTRACKER) -> void;
+    auto step(Move move) -> void;
+    auto inputs() const->std::vector<float>;
+    auto expert() -> Move;
+
+    auto isDone() const -> bool;
+    auto ticks() const -> int;
+    auto progress() const -> float;
+    auto collisions() const -> int;
+
+    auto bounds() const -> b2AABB;
+    auto snapshot(Snapshot& snapshot) const -> void;
+
+private:
+    auto begin() -> void;
+    auto BeginContact(b2Contact* contact) -> void override;
+
+    b2World world{ b2Vec2{ 0.0f, 0.0f } };
+    b2Body* ground{ nullptr };
+    const Quality::Profile* quality{ &Quality::standard };
+    std::unique_ptr<Maze> maze{};
+    std::unique_ptr<Car> car{};
+    std::unique_ptr<Follower> follower{};
+
+    int tick{ 0 };
+    int touches{ 0 };
+    float startDistance{ 0.0f };
+    float bestDistance{ 0.0f };
+};
@@ -0,0 +1,142 @@
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <omp.h>
+#include <algorithm>
+
+#include "Evaluation.hpp"
+#include "Evolution.hpp"
+#include "Episode.hpp"
+
+Evaluation::Evaluation(uint32_t seed, int episodes, Car::Dynamics dynamics, Maze::Layout layout, Maze::Generator generator)
+{
+    this->seed = seed;
+    this->dynamics = dynamics;
+    this->layout = layout;
+    this->generator = generator;
+
+    auto mt{ std::mt19937{ seed } };
+    this->seeds.resize(episodes);
+    for (auto& current : this->seeds)
+    {
+        current = mt();
+    }
+}
+
+auto Evaluation::run(const Controller& controller, const Quality::Profile& quality) -> const Result&
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto result{ Result{} };
+    result.name = controller.name;
+    result.quality = quality.name;
+    result.episodes = static_cast<int>(this->seeds.size());
+    result.runs.resize(this->seeds.size());
+
+    // One episode per worker thread, reset to each seed in turn
+    auto pool{ std::vector<std::unique_ptr<Episode>>(omp_get_max_threads()) };
+
+    const auto start{ Clock::now() };
+
+#pragma omp parallel for schedule(dynamic) if(controller.concurrent)
+    for (auto n{ 0 }; n < static_cast<int>(this->seeds.size()); ++n)
+    {
+        auto& pooled{ pool[omp_get_thread_num()] };
+        if (pooled == nullptr)
+        {
+            pooled = std::make_unique<Episode>(nullptr, this->seeds[n], this->dynamics, quality, this->layout, this->generator);
+        }
+        else
+        {
+            pooled->reset(this->seeds[n], this->generator);
+        }
+
+        auto& episode{ *pooled };
+        auto decisionTime{ Clock::duration::zero() };
+
+        while (not episode.isDone() and episode.ticks() < Evolution::ticks)
+        {
+            const auto before{ Clock::now() };
+            const auto move{ controller.decide(episode) };
+            decisionTime += Clock::now() - before;
+
+            episode.step(move);
+        }
+
+        auto& run{ result.runs[n] };
+        run.seed = this->seeds[n];
+        run.done = episode.isDone();
+        run.ticks = episode.ticks();
+        run.collisions = episode.collisions();
+        run.progress = episode.isDone() ? 1.0f : episode.progress();
+        run.decisionTime = std::chrono::duration<double, std::nano>{ decisionTime }.count();
+    }
+
+    result.elapsed = std::chrono::duration<double>{ Clock::now() - start }.count();
+
+    auto ticks{ 0.0 }, collisions{ 0.0 }, progress{ 0.0 }, decisionTime{ 0.0 }, decisions{ 0.0 };
+    for (const auto& run : result.runs)
+    {
+        if (run.done)
+        {
+            ++result.successes;
+            ticks += run.ticks;
+        }
+        collisions += run.collisions;
+        progress += run.progress;
+        decisionTime += run.decisionTime;
+        decisions += run.ticks;
+    }
+    result.meanTicks = result.successes > 0 ? ticks / result.successes : 0.0;
+    result.meanCollisions = result.episodes > 0 ? collisions / result.episodes : 0.0;
+    result.meanProgress = result.episodes > 0 ? progress / result.episodes : 0.0;
+    result.decisionCost = decisions > 0 ? decisionTime / decisions : 0.0;
+
+    return this->outcomes.emplace_back(std::move(result));
+}
+
+auto Evaluation::results() const -> const std::vector<Result>&
+{
+    return this->outcomes;
+}
+
+// One summary per controller, alongside the suite it ran on
+auto Evaluation::save(const std::string& filePath) const -> void
+{
+    auto ofs{ std::ofstream{ filePath } };
+    ofs << std::fixed << std::setprecision(3);
+    ofs << "{\n  \"seed\": " << this->seed << ",\n  \"episodes\": " << this->seeds.size() << ",\n  \"ticks\": " << Evolution::ticks
+        << ",\n  \"dynamics\": \"" << (this->dynamics == Car::Dynamics::KINEMATIC ? "kinematic" : this->dynamics == Car::Dynamics::DIRECT ? "direct" : "dynamic") << "\",\n  \"layout\": \"" << Maze::layoutNames[static_cast<int>(this->layout)]
+        << "\",\n  \"generator\": \"" << Maze::generatorNames[static_cast<int>(this->generator)] << "\",\n  \"controllers\": [";
+    for (auto n{ 0 }; n < this->outcomes.size(); ++n)
+    {
+        const auto& result{ this->outcomes[n] };
+        ofs << (n > 0 ? "," : "") << "\n    {"
+            << "\"name\": \"" << result.name << "\", "
+            << "\"quality\": \"" << result.quality << "\", "
+            << "\"successRate\": " << static_cast<double>(result.successes) / std::max(result.episodes, 1) << ", "
+            << "\"meanTicks\": " << result.meanTicks << ", "
+            << "\"meanCollisions\": " << result.meanCollisions << ", "
+            << "\"meanProgress\": " << result.meanProgress << ", "
+            << "\"decisionNs\": " << result.decisionCost << ", "
+            << "\"elapsed\": " << result.elapsed << "}";
+    }
+    ofs << "\n  ]\n}\n";
+}
+
+// Every episode of every controller, for digging into which mazes fail
+auto Evaluation::saveRuns(const std::string& filePath) const -> void
+{
+    auto ofs{ std::ofstream{ filePath } };
+    ofs << "controller;quality;seed;done;ticks;collisions;progress;decision_ns\n";
+    for (const auto& result : this->outcomes)
+    {
+        for (const auto& run : result.runs)
+        {
+            ofs << result.name << ';' << result.quality << ';' << run.seed << ';' << run.done << ';' << run.ticks << ';' << run.collisions << ';' << run.progress << ';'
+                << (run.ticks > 0 ? run.decisionTime / run.ticks : 0.0) << '\n';
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+
+#include "Car.hpp"
+#include "Maze.hpp"
+#include "Quality.hpp"
+
+class Episode;
+
+// Drives controllers over one seeded suite of mazes, so their numbers are comparable run to run
+class Evaluation
+{
+public:
+    struct Controller
+    {
+        std::string name;
+        std::function<Move(Episode&)> decide;
+        bool concurrent; // decide can be called from several threads at once
+    };
+
+    struct Run
+    {
+        uint32_t seed;
+        bool done;
+        int ticks;
+        int collisions;
+        float progress; // share of the maze distance covered, 1 once done
+        double decisionTime; // nanoseconds, summed over the episode
+    };
+
+    struct Result
+    {
+        std::string name;
+        std::string quality;
+        int episodes;
+        int successes;
+        double meanTicks; // successful episodes only
+        double meanCollisions;
+        double meanProgress;
+        double decisionCost; // nanoseconds per decision
+        double elapsed; // seconds of wall clock for the whole suite
+        std::vector<Run> runs;
+    };
+
+    Evaluation(uint32_t seed, int episodes, Car::Dynamics dynamics = Car::Dynamics::DYNAMIC, Maze::Layout layout = Maze::Layout::GENERATED, Maze::Generator generator = Maze::Generator::BACKTRACKER);
+
+    auto run(const Controller& controller, const Quality::Profile& quality = Quality::standard) -> const Result&;
+    auto results() const -> const std::vector<Result>&;
+
+    auto save(const std::string& filePath) const -> void;
+    auto saveRuns(const std::string& filePath) const -> void;
+
+private:
+    uint32_t seed{ 0 };
+    Car::Dynamics dynamics{ Car::Dynamics::DYNAMIC };
+    Maze::Layout layout{ Maze::Layout::GENERATED }; // the fixed track ignores the seed, every episode would be the same
+    Maze::Generator generator{ Maze::Generator::BACKTRACKER };
+    std::vector<uint32_t> seeds{};
+    std::vector<Result> outcomes{};
+};
@@ -0,0 +1,218 @@
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+#include <omp.h>
+
+#include "Evolution.hpp"
+#include "Episode.hpp"
+
+Evolution::Evolution(const std::vector<int>& topology, int population, const Noise* noise, Car::Dynamics dynamics, Maze::Layout layout, Maze::Generator generator)
+{
+    assert(population > Evolution::elites);
+
+    this->noise = noise;
+    this->dynamics = dynamics;
+    this->layout = layout;
+    this->generator = generator;
+
+    this->networks.reserve(population);
+    for (auto n{ 0 }; n < population; ++n)
+    {
+        this->networks.emplace_back(topology, mt);
+    }
+    this->fitness.resize(population, 0.0f);
+
+    this->champion = this->networks.front();
+}
+
+auto Evolution::generation() -> void
+{
+    this->evaluate();
+    this->evolve();
+    ++this->current;
+}
+
+// Every individual drives the same mazes, and so does the champion again, so the scores compare networks rather than luck
+auto Evolution::evaluate() -> void
+{
+    const auto population{ static_cast<int>(this->networks.size()) };
+    const auto candidates{ this->current > 0 ? population + 1 : population };
+    auto scores{ std::vector<float>(candidates * Evolution::episodes, 0.0f) };
+
+    auto seeds{ std::array<uint32_t, Evolution::episodes>{} };
+    for (auto& seed : seeds)
+    {
+        seed = this->mt();
+    }
+
+    this->episodesPool.resize(std::max<size_t>(this->episodesPool.size(), omp_get_max_threads()));
+
+#pragma omp parallel for schedule(dynamic)
+    for (auto n{ 0 }; n < candidates * Evolution::episodes; ++n)
+    {
+        const auto candidate{ n / Evolution::episodes };
+        const auto& network{ candidate < population ? this->networks[candidate] : this->champion };
+        const auto seed{ seeds[n % Evolution::episodes] };
+
+        auto& pooled{ this->episodesPool[omp_get_thread_num()] };
+        if (pooled == nullptr)
+        {
+            pooled = std::make_unique<Episode>(this->noise, seed, this->dynamics, Quality::standard, this->layout, this->generator);
+        }
+        else
+        {
+            pooled->reset(seed, this->generator);
+        }
+
+        auto& episode{ *pooled };
+        while (not episode.isDone() and episode.ticks() < Evolution::ticks)
+        {
+            episode.step(Car::decide(network.inference(episode.inputs())));
+        }
+
+        // Progress toward the end, plus a bonus for finishing that grows the faster it gets there
+        scores[n] = episode.progress();
+        if (episode.isDone())
+        {
+            scores[n] += 2.0f - static_cast<float>(episode.ticks()) / Evolution::ticks;
+        }
+    }
+
+    for (auto n{ 0 }; n < population; ++n)
+    {
+        const auto begin{ scores.begin() + n * Evolution::episodes };
+        this->fitness[n] = std::accumulate(begin, begin + Evolution::episodes, 0.0f) / Evolution::episodes;
+    }
+
+    this->mean = std::accumulate(this->fitness.begin(), this->fitness.end(), 0.0f) / population;
+
+    // The champion's standing is its score on this generation's mazes, and only a strictly better network takes its place
+    if (this->current > 0)
+    {
+        const auto begin{ scores.begin() + population * Evolution::episodes };
+        this->championFitness = std::accumulate(begin, begin + Evolution::episodes, 0.0f) / Evolution::episodes;
+    }
+
+    const auto best{ std::max_element(this->fitness.begin(), this->fitness.end()) };
+    if (this->current == 0 or *best > this->championFitness)
+    {
+        this->championFitness = *best;
+        this->champion = this->networks[best - this->fitness.begin()];
+    }
+}
+
+auto Evolution::evolve() -> void
+{
+    auto order{ std::vector<int>(this->networks.size()) };
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return this->fitness[a] > this->fitness[b]; });
+
+    auto offspring{ std::vector<Network>{} };
+    offspring.reserve(this->networks.size());
+
+    for (auto n{ 0 }; n < Evolution::elites; ++n)
+    {
+        offspring.emplace_back(this->networks[order[n]]);
+    }
+
+    while (offspring.size() < this->networks.size())
+    {
+        const auto& first{ this->select() };
+        const auto& second{ this->select() };
+
+        auto child{ this->crossover(first, second) };
+        this->mutate(child);
+
+        offspring.emplace_back(std::move(child));
+    }
+
+    this->networks = std::move(offspring);
+}
+
+auto Evolution::select() -> const Network&
+{
+    auto dist{ std::uniform_int_distribution<int>{ 0, static_cast<int>(this->networks.size()) - 1 } };
+
+    auto best{ dist(mt) };
+    for (auto n{ 1 }; n < Evolution::tournament; ++n)
+    {
+        const auto candidate{ dist(mt) };
+        if (this->fitness[candidate] > this->fitness[best])
+        {
+            best = candidate;
+        }
+    }
+
+    return this->networks[best];
+}
+
+auto Evolution::crossover(const Network& first, const Network& second) -> Network
+{
+    auto child{ first };
+    auto coin{ std::bernoulli_distribution{ 0.5 } };
+
+    // Uniform crossover by neuron, so each output keeps its incoming weights and bias together
+    for (auto l{ 0 }; l < child.size(); ++l)
+    {
+        auto& layer{ child.layer(l) };
+        const auto& other{ second.layer(l) };
+
+        for (auto o{ 0 }; o < layer.outputs; ++o)
+        {
+            if (coin(mt))
+            {
+                std::copy_n(other.weights.begin() + o * layer.inputs, layer.inputs, layer.weights.begin() + o * layer.inputs);
+                layer.biases[o] = other.biases[o];
+            }
+        }
+    }
+
+    return child;
+}
+
+auto Evolution::mutate(Network& network) -> void
+{
+    auto chance{ std::bernoulli_distribution{ Evolution::mutationRate } };
+    auto dist{ std::normal_distribution{ 0.0f, Evolution::mutationStrength } };
+
+    for (auto l{ 0 }; l < network.size(); ++l)
+    {
+        auto& layer{ network.layer(l) };
+
+        for (auto& weight : layer.weights)
+        {
+            if (chance(mt))
+            {
+                weight += dist(mt);
+            }
+        }
+        for (auto& bias : layer.biases)
+        {
+            if (chance(mt))
+            {
+                bias += dist(mt);
+            }
+        }
+    }
+}
+
+auto Evolution::best() const -> const Network&
+{
+    return this->champion;
+}
+
+auto Evolution::bestFitness() const -> float
+{
+    return this->championFitness;
+}
+
+auto Evolution::meanFitness() const -> float
+{
+    return this->mean;
+}
+
+auto Evolution::generations() const -> int
+{
+    return this->current;
+}
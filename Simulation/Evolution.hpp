@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <random>
+#include <memory>
+
+#include "..\Network.hpp"
+#include "..\Noise.hpp"
+#include "Car.hpp"
+#include "Episode.hpp"
+
+class Evolution
+{
+public:
+    Evolution(const std::vector<int>& topology, int population, const Noise* noise = nullptr, Car::Dynamics dynamics = Car::Dynamics::DYNAMIC, Maze::Layout layout = Maze::Layout::GENERATED, Maze::Generator generator = Maze::Generator::BACKTRACKER);
+
+    auto generation() -> void;
+
+    auto best() const -> const Network&;
+    auto bestFitness() const -> float;
+    auto meanFitness() const -> float;
+    auto generations() const -> int;
+
+    static constexpr int episodes{ 3 };
+    static constexpr int ticks{ 600 };
+    static constexpr int elites{ 2 };
+    static constexpr int tournament{ 4 };
+    static constexpr float mutationRate{ 0.05f };
+    static constexpr float mutationStrength{ 0.1f };
+
+private:
+    auto evaluate() -> void;
+    auto evolve() -> void;
+    auto select() -> const Network&;
+    auto crossover(const Network& first, const Network& second) -> Network;
+    auto mutate(Network& network) -> void;
+
+    const Noise* noise{ nullptr };
+    Car::Dynamics dynamics{ Car::Dynamics::DYNAMIC };
+    Maze::Layout layout{ Maze::Layout::GENERATED };
+    Maze::Generator generator{ Maze::Generator::BACKTRACKER };
+    std::mt19937 mt{ std::random_device{}() };
+
+    std::vector<std::unique_ptr<Episode>> episodesPool{}; // one per worker thread
+
+    std::vector<Network> networks{};
+    std::vector<float> fitness{};
+
+    Network champion{};
+    float championFitness{ 0.0f };
+    float mean{ 0.0f };
+    int current{ 0 };
+};
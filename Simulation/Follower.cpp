@@ -1,6 +1,7 @@
 #include <cmath>
 
 #include "Follower.hpp"
+#include "..\Profiler.hpp"
 
 
 Follower::Follower(Car* car, const std::vector<b2Vec2>& path)
@@ -32,41 +33,61 @@ auto Follower::nextPoint() -> void
 	{
 		this->targetPoint++;
 
-		if (this->targetPoint == this->path.size())
-		{
-			return;
-		}
+		this->aim();
+	}
+}
 
-		const auto carDistance{ this->path[this->targetPoint] - carPosition };
-		const auto carAngle{ Follower::normalizeAngle(this->car->angle() + b2_pi / 2.0f) };
+// Turns towards the target point from where the car is now
+auto Follower::aim() -> void
+{
+	if (this->targetPoint == this->path.size())
+	{
+		return;
+	}
 
-		this->targetAngle = Follower::normalizeAngle(std::atan2(carDistance.y, carDistance.x));
+	const auto carDistance{ this->path[this->targetPoint] - this->car->position() };
+	const auto carAngle{ Follower::normalizeAngle(this->car->angle() + b2_pi / 2.0f) };
 
-		const auto da{ this->targetAngle - carAngle };
-		if ((da > +0.075f and da < +b2_pi) or da < -b2_pi)
-		{
-			this->adjustingAngle = -1; // RIGHT
-		}
-		else if ((da < -0.075f and da > -b2_pi) or da > +b2_pi)
-		{
-			this->adjustingAngle = +1; // LEFT
-		}
-		else
-		{
-			this->adjustingAngle = 0; // NONE
-		}
+	this->targetAngle = Follower::normalizeAngle(std::atan2(carDistance.y, carDistance.x));
+
+	const auto da{ this->targetAngle - carAngle };
+	if ((da > +0.075f and da < +b2_pi) or da < -b2_pi)
+	{
+		this->adjustingAngle = -1; // RIGHT
 	}
+	else if ((da < -0.075f and da > -b2_pi) or da > +b2_pi)
+	{
+		this->adjustingAngle = +1; // LEFT
+	}
+	else
+	{
+		this->adjustingAngle = 0; // NONE
+	}
+}
+
+auto Follower::step(bool drive) -> void
+{
+	const auto scope{ Profiler::Scope{ Profiler::Phase::FOLLOWER } };
+
+	this->nextPoint();
+	this->followPath(drive);
 }
 
-auto Follower::step() -> void
+// The move for the car as it is, without driving it: when another driver has the car,
+// the heading set at the last waypoint no longer holds, so it is aimed again every time
+auto Follower::expert() -> Move
 {
+	const auto scope{ Profiler::Scope{ Profiler::Phase::FOLLOWER } };
+
 	this->nextPoint();
-	this->followPath();
+	this->aim();
+	this->followPath(false);
+	return this->move;
 }
 
-auto Follower::render(GPU_Target* target) const -> void
+auto Follower::snapshot(Snapshot::Path& snapshot) const -> void
 {
-	this->renderPath(target);
+	snapshot.points.assign(this->path.begin(), this->path.end());
 }
 
 auto Follower::isDone() const -> bool
@@ -74,7 +95,21 @@ auto Follower::isDone() const -> bool
 	return (this->targetPoint == this->path.size());
 }
 
-auto Follower::followPath() -> void
+// Whether the car is still in a tile of the path left to drive, the one it is leaving included
+auto Follower::isOnPath(const Maze& maze) const -> bool
+{
+	const auto carPosition{ this->car->position() };
+	for (auto n{ this->targetPoint > 0 ? this->targetPoint - 1 : 0 }; n < this->path.size(); ++n)
+	{
+		if (maze.isSameTile(this->path[n], carPosition))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+auto Follower::followPath(bool drive) -> void
 {
 	if (this->targetPoint == this->path.size())
 	{
@@ -113,21 +148,13 @@ auto Follower::followPath() -> void
 			}
 		}
 	}
-	this->car->doMove(this->move);
+	if (drive)
+	{
+		this->car->doMove(this->move);
+	}
 }
 
 auto Follower::movement() const->Move
 {
 	return this->move;
-}
-
-auto Follower::renderPath(GPU_Target* target) const -> void
-{
-	for (auto n{ 1 }; n < this->path.size(); ++n)
-	{
-		const auto [x1, y1] { this->path[n - 1] };
-		const auto [x2, y2] { this->path[n] };
-
-		GPU_Line(target, x1, y1, x2, y2, { 0,255,0,255 });
-	}
 }
\ No newline at end of file
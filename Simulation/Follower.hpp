@@ -11,15 +11,17 @@ class Follower
 public:
     Follower(Car* car, const std::vector<b2Vec2>& path);
 
-    auto step() -> void;
-    auto render(GPU_Target* target) const -> void;
+    auto step(bool drive = true) -> void;
+    auto expert() -> Move;
+    auto snapshot(Snapshot::Path& snapshot) const -> void;
     auto isDone() const -> bool;
+    auto isOnPath(const Maze& maze) const -> bool;
     auto movement() const->Move;
 private:
     static auto normalizeAngle(float angle) -> float;
     auto nextPoint() -> void;
-    auto followPath() -> void;
-    auto renderPath(GPU_Target* target) const -> void;
+    auto aim() -> void;
+    auto followPath(bool drive) -> void;
 
     Car* car{ nullptr };
     std::vector<b2Vec2> path{};
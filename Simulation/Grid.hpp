@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// One bit per cell in 64 bit words, for the visited sets of generation and solving
+class Bitmap
+{
+public:
+    Bitmap() = default;
+
+    Bitmap(size_t size)
+    {
+        this->words.resize((size + 63) / 64, 0);
+    }
+
+    auto test(size_t index) const -> bool
+    {
+        return (this->words[index / 64] >> (index % 64)) & 1;
+    }
+
+    auto set(size_t index) -> void
+    {
+        this->words[index / 64] |= uint64_t{ 1 } << (index % 64);
+    }
+
+    auto reset(size_t index) -> void
+    {
+        this->words[index / 64] &= ~(uint64_t{ 1 } << (index % 64));
+    }
+
+private:
+    std::vector<uint64_t> words{};
+};
+
+// Maze walls packed two bits per cell, the wall to its right and the one below it.
+// The wall above a cell is the one below its upper neighbour, the outer border is always closed.
+class Grid
+{
+public:
+    struct Tile
+    {
+        bool up, down;
+        bool left, right;
+    };
+
+    Grid() = default;
+
+    // Every wall closed
+    Grid(size_t rows, size_t columns)
+    {
+        this->height = rows;
+        this->width = columns;
+        this->words.resize((2 * rows * columns + 63) / 64, ~uint64_t{ 0 });
+    }
+
+    auto rows() const -> size_t
+    {
+        return this->height;
+    }
+
+    auto columns() const -> size_t
+    {
+        return this->width;
+    }
+
+    auto cells() const -> size_t
+    {
+        return this->height * this->width;
+    }
+
+    auto index(int y, int x) const -> size_t
+    {
+        return static_cast<size_t>(y) * this->width + x;
+    }
+
+    auto right(int y, int x) const -> bool
+    {
+        return x + 1 >= static_cast<int>(this->width) or this->bit(2 * this->index(y, x));
+    }
+
+    auto down(int y, int x) const -> bool
+    {
+        return y + 1 >= static_cast<int>(this->height) or this->bit(2 * this->index(y, x) + 1);
+    }
+
+    auto left(int y, int x) const -> bool
+    {
+        return x == 0 or this->right(y, x - 1);
+    }
+
+    auto up(int y, int x) const -> bool
+    {
+        return y == 0 or this->down(y - 1, x);
+    }
+
+    auto tile(int y, int x) const -> Tile
+    {
+        return Tile{ this->up(y, x), this->down(y, x), this->left(y, x), this->right(y, x) };
+    }
+
+    // Removes the wall between a cell and one of its four neighbours
+    auto open(int y, int x, int dy, int dx) -> void
+    {
+        if (dy == -1)
+        {
+            this->clear(2 * this->index(y - 1, x) + 1);
+        }
+        else if (dy == +1)
+        {
+            this->clear(2 * this->index(y, x) + 1);
+        }
+        else if (dx == -1)
+        {
+            this->clear(2 * this->index(y, x - 1));
+        }
+        else if (dx == +1)
+        {
+            this->clear(2 * this->index(y, x));
+        }
+    }
+
+    auto bytes() const -> size_t
+    {
+        return this->words.size() * sizeof(uint64_t);
+    }
+
+private:
+    auto bit(size_t index) const -> bool
+    {
+        return (this->words[index / 64] >> (index % 64)) & 1;
+    }
+
+    auto clear(size_t index) -> void
+    {
+        this->words[index / 64] &= ~(uint64_t{ 1 } << (index % 64));
+    }
+
+    size_t height{ 0 };
+    size_t width{ 0 };
+    std::vector<uint64_t> words{};
+};
@@ -7,85 +7,91 @@
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <tuple>
+#include <numeric>
+#include <algorithm>
 
 #include <box2d/box2d.h>
 #include <SDL_gpu.h>
 #include <SDL_FontCache.h>
 
 #include "maze.hpp"
+#include "Eller.hpp"
 #include "..\Draw.hpp"
+#include "..\Profiler.hpp"
 
-auto Maze::make(size_t rows, size_t columns) -> Matrix
+auto Maze::make(size_t rows, size_t columns, std::optional<uint32_t> seed, Generator generator) -> Matrix
 {
-    auto matrix{ std::vector(rows,std::vector(columns,Tile{true,true,true,true})) };
+    auto rd{ std::random_device{} };
+    const auto value{ seed.has_value() ? *seed : rd() };
+
+    switch (generator)
+    {
+        case Generator::ELLER:
+            return Maze::eller(rows, columns, value);
+        case Generator::KRUSKAL:
+            return Maze::kruskal(rows, columns, value);
+        case Generator::WILSON:
+            return Maze::wilson(rows, columns, value);
+        case Generator::BRAID:
+            return Maze::braid(rows, columns, value);
+        default:
+            return Maze::backtracker(rows, columns, value);
+    }
+}
+
+auto Maze::backtracker(size_t rows, size_t columns, uint32_t seed) -> Matrix
+{
+    auto matrix{ Matrix{ rows, columns } };
+    auto visited{ Bitmap{ matrix.cells() } };
 
-    auto tracking{ std::deque<std::tuple<int,int>>{} };
+    auto tracking{ std::vector<std::pair<int,int>>{} };
     
-    auto rd{ std::random_device{} };
-    auto mt{ std::mt19937{rd()} };
+    auto mt{ std::mt19937{ seed } };
 
     auto j{ 0 }, i{ 0 };
 
+    visited.set(matrix.index(j, i));
     tracking.emplace_back(j, i);
     while (1)
     {
-        auto directions{ std::vector<std::tuple<int,int>>{} };
+        auto directions{ std::array<std::pair<int,int>, 4>{} };
+        auto count{ 0 };
 
         const auto unvisited{ [&](int dj, int di) -> bool
         {
-            return matrix[j + dj][i + di].up
-                && matrix[j + dj][i + di].down
-                && matrix[j + dj][i + di].left
-                && matrix[j + dj][i + di].right;
+            return not visited.test(matrix.index(j + dj, i + di));
         } };
 
         if (j > 0 and unvisited(-1, 0))
         {
-            directions.emplace_back(-1, 0);
+            directions[count++] = { -1, 0 };
         }
-        if (j < rows - 1 and unvisited(+1, 0))
+        if (j < static_cast<int>(rows) - 1 and unvisited(+1, 0))
         {
-            directions.emplace_back(+1, 0);
+            directions[count++] = { +1, 0 };
         }
         if (i > 0 and unvisited(0, -1))
         {
-            directions.emplace_back(0, -1);
+            directions[count++] = { 0, -1 };
         }
-        if (i < columns - 1 and unvisited(0, +1))
+        if (i < static_cast<int>(columns) - 1 and unvisited(0, +1))
         {
-            directions.emplace_back(0, +1);
+            directions[count++] = { 0, +1 };
         }
 
-        if (directions.size() > 0)
+        if (count > 0)
         {
-            auto dist{ std::uniform_int_distribution<int>{ 0, static_cast<int>(directions.size()) - 1} };
+            auto dist{ std::uniform_int_distribution<int>{ 0, count - 1 } };
             const auto choosen{ dist(mt) };
             const auto [dj, di] { directions[choosen] };
 
-            if (dj == +1)
-            {
-                matrix[j][i].down = false;
-                matrix[j + 1][i].up = false;
-            }
-            else if (dj == -1)
-            {
-                matrix[j][i].up = false;
-                matrix[j - 1][i].down = false;
-            }
-            else if (di == +1)
-            {
-                matrix[j][i].right = false;
-                matrix[j][i + 1].left = false;
-            }
-            else if (di == -1)
-            {
-                matrix[j][i].left = false;
-                matrix[j][i - 1].right = false;
-            }
+            matrix.open(j, i, dj, di);
 
             j += dj;
             i += di;
 
+            visited.set(matrix.index(j, i));
             tracking.emplace_back(j, i);
         }
         else
@@ -102,99 +108,374 @@ auto Maze::make(size_t rows, size_t columns) -> Matrix
     return matrix;
 }
 
-auto Maze::solve(const Matrix& matrix, int y, int x, bool bestSolution)->Path
+auto Maze::eller(size_t rows, size_t columns, uint32_t seed) -> Matrix
 {
-    auto solution{ Path{} };
+    auto matrix{ Matrix{ rows, columns } };
+    auto generator{ Eller{ columns, seed } };
 
-    auto visited{ std::vector(matrix.size(), std::vector(matrix.front().size(), false)) };
-    auto tracking{ std::deque<std::tuple<int,int,int>>{} };
+    for (auto j{ 0 }; j < static_cast<int>(rows); ++j)
+    {
+        generator.advance(j + 1 == static_cast<int>(rows));
+        for (auto i{ 0 }; i < static_cast<int>(columns); ++i)
+        {
+            if (generator.right(i))
+            {
+                matrix.open(j, i, 0, +1);
+            }
+            if (generator.down(i))
+            {
+                matrix.open(j, i, +1, 0);
+            }
+        }
+    }
 
-    tracking.emplace_back(0, y, x);
+    return matrix;
+}
 
-    while (not tracking.empty())
+// Every inner wall in random order, knocked down when it separates two cells not yet connected
+auto Maze::kruskal(size_t rows, size_t columns, uint32_t seed) -> Matrix
+{
+    auto matrix{ Matrix{ rows, columns } };
+    auto mt{ std::mt19937{ seed } };
+
+    // Wall 2 * cell is the one to its right, 2 * cell + 1 the one below it
+    auto walls{ std::vector<uint32_t>{} };
+    walls.reserve(2 * matrix.cells());
+    for (auto j{ 0 }; j < static_cast<int>(rows); ++j)
     {
-        auto& [dir, j, i] { tracking.back() };
+        for (auto i{ 0 }; i < static_cast<int>(columns); ++i)
+        {
+            if (i + 1 < static_cast<int>(columns))
+            {
+                walls.emplace_back(static_cast<uint32_t>(2 * matrix.index(j, i)));
+            }
+            if (j + 1 < static_cast<int>(rows))
+            {
+                walls.emplace_back(static_cast<uint32_t>(2 * matrix.index(j, i) + 1));
+            }
+        }
+    }
+    std::shuffle(walls.begin(), walls.end(), mt);
+
+    auto parents{ std::vector<uint32_t>(matrix.cells()) };
+    std::iota(parents.begin(), parents.end(), 0);
+
+    const auto find{ [&](uint32_t cell)
+    {
+        while (parents[cell] != cell)
+        {
+            parents[cell] = parents[parents[cell]];
+            cell = parents[cell];
+        }
+        return cell;
+    } };
+
+    for (const auto wall : walls)
+    {
+        const auto cell{ wall / 2 };
+        const auto j{ static_cast<int>(cell / columns) };
+        const auto i{ static_cast<int>(cell % columns) };
+        const auto dj{ static_cast<int>(wall % 2) };
+        const auto di{ 1 - dj };
+
+        const auto a{ find(cell) };
+        const auto b{ find(static_cast<uint32_t>(matrix.index(j + dj, i + di))) };
+        if (a != b)
+        {
+            parents[b] = a;
+            matrix.open(j, i, dj, di);
+        }
+    }
+
+    return matrix;
+}
+
+// Loop erased random walks from every cell outside the maze until they hit it, so every spanning tree is equally likely
+auto Maze::wilson(size_t rows, size_t columns, uint32_t seed) -> Matrix
+{
+    auto matrix{ Matrix{ rows, columns } };
+    auto mt{ std::mt19937{ seed } };
 
-        if (bestSolution)
+    static constexpr std::array<std::pair<int,int>, 4> steps{ { { -1, 0 }, { +1, 0 }, { 0, -1 }, { 0, +1 } } };
+
+    auto inside{ Bitmap{ matrix.cells() } };
+    auto exits{ std::vector<uint8_t>(matrix.cells()) }; // last direction the walk left each cell through, overwriting erases the loops
+
+    const auto walk{ [&](int& j, int& i)
+    {
+        auto directions{ std::array<uint8_t, 4>{} };
+        auto count{ 0 };
+        for (auto d{ uint8_t{ 0 } }; d < 4; ++d)
         {
-            if (j == 0 and i == 0)
+            const auto nj{ j + steps[d].first };
+            const auto ni{ i + steps[d].second };
+            if (nj >= 0 and ni >= 0 and nj < static_cast<int>(rows) and ni < static_cast<int>(columns))
             {
-                while (1)
-                {
-                    auto& [dir, j, i] { tracking.back() };
-                    solution.emplace(solution.begin(), Coordinate{ i, j });
-                    if (j == y and i == x)
-                    {
-                        break;
-                    }
-                    tracking.pop_back();
-                }
-                break;
+                directions[count++] = d;
             }
         }
-        else
+
+        auto dist{ std::uniform_int_distribution<int>{ 0, count - 1 } };
+        const auto d{ directions[dist(mt)] };
+        exits[matrix.index(j, i)] = d;
+        j += steps[d].first;
+        i += steps[d].second;
+    } };
+
+    inside.set(0);
+    for (auto start{ size_t{ 1 } }; start < matrix.cells(); ++start)
+    {
+        if (inside.test(start))
+        {
+            continue;
+        }
+
+        auto j{ static_cast<int>(start / columns) };
+        auto i{ static_cast<int>(start % columns) };
+        while (not inside.test(matrix.index(j, i)))
+        {
+            walk(j, i);
+        }
+
+        j = static_cast<int>(start / columns);
+        i = static_cast<int>(start % columns);
+        while (not inside.test(matrix.index(j, i)))
+        {
+            inside.set(matrix.index(j, i));
+            const auto [dj, di] { steps[exits[matrix.index(j, i)]] };
+            matrix.open(j, i, dj, di);
+            j += dj;
+            i += di;
+        }
+    }
+
+    return matrix;
+}
+
+// A backtracker maze with every dead end opened into a neighbour, preferably another dead end, so it is full of loops
+auto Maze::braid(size_t rows, size_t columns, uint32_t seed) -> Matrix
+{
+    auto matrix{ Maze::backtracker(rows, columns, seed) };
+    auto mt{ std::mt19937{ seed ^ 0x9E3779B9u } };
+
+    const auto walls{ [&](int j, int i)
+    {
+        const auto tile{ matrix.tile(j, i) };
+        return tile.up + tile.down + tile.left + tile.right;
+    } };
+
+    for (auto j{ 0 }; j < static_cast<int>(rows); ++j)
+    {
+        for (auto i{ 0 }; i < static_cast<int>(columns); ++i)
         {
-            solution.emplace_back(Coordinate{ i, j });
+            if (walls(j, i) != 3)
+            {
+                continue;
+            }
 
-            if (j == 0 and i == 0)
+            // Dead end neighbours first, one opening removes both
+            auto deadEnds{ std::array<std::pair<int,int>, 4>{} };
+            auto others{ std::array<std::pair<int,int>, 4>{} };
+            auto deadEndCount{ 0 }, otherCount{ 0 };
+            const auto consider{ [&](bool wall, int dj, int di)
             {
-                break;
+                const auto nj{ j + dj };
+                const auto ni{ i + di };
+                if (not wall or nj < 0 or ni < 0 or nj >= static_cast<int>(rows) or ni >= static_cast<int>(columns))
+                {
+                    return;
+                }
+                if (walls(nj, ni) == 3)
+                {
+                    deadEnds[deadEndCount++] = { dj, di };
+                }
+                else
+                {
+                    others[otherCount++] = { dj, di };
+                }
+            } };
+
+            const auto tile{ matrix.tile(j, i) };
+            consider(tile.up, -1, 0);
+            consider(tile.down, +1, 0);
+            consider(tile.left, 0, -1);
+            consider(tile.right, 0, +1);
+
+            const auto& candidates{ deadEndCount > 0 ? deadEnds : others };
+            const auto count{ deadEndCount > 0 ? deadEndCount : otherCount };
+            if (count > 0)
+            {
+                auto dist{ std::uniform_int_distribution<int>{ 0, count - 1 } };
+                const auto [dj, di] { candidates[dist(mt)] };
+                matrix.open(j, i, dj, di);
             }
         }
+    }
+
+    return matrix;
+}
+
+// The shortest path reads straight off the distance field, the exploring one is the backtracking walk a car would drive
+auto Maze::solve(const Matrix& matrix, int y, int x, bool bestSolution, Coordinate goal)->Path
+{
+    if (bestSolution)
+    {
+        return Maze::descend(matrix, Maze::field(matrix, goal), y, x);
+    }
+
+    auto solution{ Path{} };
+
+    auto visited{ Bitmap{ matrix.cells() } };
+    auto tracking{ std::vector<std::tuple<int,int,int>>{} };
+
+    tracking.emplace_back(0, y, x);
+
+    while (not tracking.empty())
+    {
+        // Copied out and advanced first, pushing a neighbour may move the stack
+        const auto [dir, j, i] { tracking.back() };
+        ++std::get<0>(tracking.back());
+
+        solution.emplace_back(Coordinate{ i, j });
+
+        if (j == goal.y and i == goal.x)
+        {
+            break;
+        }
 
         if (dir == 0) // UP
         {
-            if (j - 1 >= 0 and not matrix[j][i].up and not visited[j - 1][i])
+            if (not matrix.up(j, i) and not visited.test(matrix.index(j - 1, i)))
             {
-                visited[j - 1][i] = true;
+                visited.set(matrix.index(j - 1, i));
                 tracking.emplace_back(0, j - 1, i);
             }
         }
         else if (dir == 1) // LEFT
         {
-            if (i - 1 >= 0 and not matrix[j][i].left and not visited[j][i - 1])
+            if (not matrix.left(j, i) and not visited.test(matrix.index(j, i - 1)))
             {
-                visited[j][i - 1] = true;
+                visited.set(matrix.index(j, i - 1));
                 tracking.emplace_back(0, j, i - 1);
             }
         }
         else if (dir == 2) // DOWN
         {
-            if (j + 1 < matrix.size() and not matrix[j][i].down and not visited[j + 1][i])
+            if (not matrix.down(j, i) and not visited.test(matrix.index(j + 1, i)))
             {
-                visited[j + 1][i] = true;
+                visited.set(matrix.index(j + 1, i));
                 tracking.emplace_back(0, j + 1, i);
             }
         }
         else if (dir == 3) // RIGHT
         {
-            if (i + 1 < matrix.front().size() and not matrix[j][i].right and not visited[j][i + 1])
+            if (not matrix.right(j, i) and not visited.test(matrix.index(j, i + 1)))
             {
-                visited[j][i + 1] = true;
+                visited.set(matrix.index(j, i + 1));
                 tracking.emplace_back(0, j, i + 1);
             }
         }
         else
         {
-            visited[j][i] = false;
+            // Stays visited, coming back through a loop would only walk the same dead ends again
             tracking.pop_back();
         }
-
-        dir++;
     }
 
     return solution;
 }
 
+// Breadth first from the goal, one pass over the maze
+auto Maze::field(const Matrix& matrix, Coordinate goal)->Field
+{
+    auto field{ Field(matrix.cells(), Maze::unreachable) };
+    if (matrix.cells() == 0)
+    {
+        return field;
+    }
+
+    auto queue{ std::vector<uint32_t>{} };
+    queue.reserve(matrix.cells());
+
+    const auto start{ static_cast<uint32_t>(matrix.index(goal.y, goal.x)) };
+    field[start] = 0;
+    queue.emplace_back(start);
+    for (auto head{ size_t{ 0 } }; head < queue.size(); ++head)
+    {
+        const auto cell{ queue[head] };
+        const auto j{ static_cast<int>(cell / matrix.columns()) };
+        const auto i{ static_cast<int>(cell % matrix.columns()) };
+
+        const auto visit{ [&](bool wall, int dj, int di)
+        {
+            const auto next{ matrix.index(j + dj, i + di) };
+            if (not wall and field[next] == Maze::unreachable)
+            {
+                field[next] = field[cell] + 1;
+                queue.emplace_back(static_cast<uint32_t>(next));
+            }
+        } };
+
+        visit(matrix.up(j, i), -1, 0);
+        visit(matrix.left(j, i), 0, -1);
+        visit(matrix.down(j, i), +1, 0);
+        visit(matrix.right(j, i), 0, +1);
+    }
+
+    return field;
+}
+
+// Follows the field downhill from (y, x), so the path costs its own length and nothing else
+auto Maze::descend(const Matrix& matrix, const Field& field, int y, int x)->Path
+{
+    auto path{ Path{} };
+    if (field[matrix.index(y, x)] == Maze::unreachable)
+    {
+        return path;
+    }
+
+    path.reserve(field[matrix.index(y, x)] + 1);
+    path.emplace_back(Coordinate{ x, y });
+    while (field[matrix.index(y, x)] > 0)
+    {
+        const auto next{ field[matrix.index(y, x)] - 1 };
+        if (not matrix.up(y, x) and field[matrix.index(y - 1, x)] == next)
+        {
+            --y;
+        }
+        else if (not matrix.left(y, x) and field[matrix.index(y, x - 1)] == next)
+        {
+            --x;
+        }
+        else if (not matrix.down(y, x) and field[matrix.index(y + 1, x)] == next)
+        {
+            ++y;
+        }
+        else
+        {
+            ++x;
+        }
+        path.emplace_back(Coordinate{ x, y });
+    }
+
+    return path;
+}
+
 auto Maze::startPoint() const -> b2Vec2
 {
-    //return this->toRealPoint({ static_cast<int>(this->columns() - 1), static_cast<int>(this->rows() - 1) });
+    if (this->layout == Layout::GENERATED)
+    {
+        return this->toRealPoint({ static_cast<int>(this->columns() - 1), static_cast<int>(this->rows() - 1) });
+    }
     return this->body->GetWorldPoint(b2Vec2{ 1.335, 0.825f });
 }
 
 auto Maze::endPoint() const -> b2Vec2
 {
-    //return this->toRealPoint({ 0, 0 });
+    if (this->layout == Layout::GENERATED)
+    {
+        return this->toRealPoint({ 0, 0 });
+    }
     return this->body->GetWorldPoint(b2Vec2{ 0.65f, 0.25f });
 }
 
@@ -208,6 +489,13 @@ auto Maze::isOnEnd(const b2Vec2& point) const -> bool
     return this->end->TestPoint(point);
 }
 
+auto Maze::isSameTile(const b2Vec2& a, const b2Vec2& b) const -> bool
+{
+    const auto first{ this->toLocalCoordinate(a) };
+    const auto second{ this->toLocalCoordinate(b) };
+    return first.x == second.x and first.y == second.y;
+}
+
 auto Maze::print(const Matrix& matrix, const Path& path) -> void
 {
     static constexpr auto square{ '\xDB' };
@@ -219,9 +507,9 @@ auto Maze::print(const Matrix& matrix, const Path& path) -> void
     {
         auto y{ 0 };
 
-        for (auto x{ 0 }; x < matrix[y].size(); ++x)
+        for (auto x{ 0 }; x < matrix.columns(); ++x)
         {
-            if (matrix[y][x].up)
+            if (matrix.up(y, x))
             {
                 std::cout << square;
             }
@@ -236,9 +524,9 @@ auto Maze::print(const Matrix& matrix, const Path& path) -> void
         std::cout << std::endl;
     }
 
-    for (auto y{ 0 }; y < matrix.size(); ++y)
+    for (auto y{ 0 }; y < matrix.rows(); ++y)
     {
-        if (matrix[y].front().left)
+        if (matrix.left(y, 0))
         {
             std::cout << square;
         }
@@ -247,7 +535,7 @@ auto Maze::print(const Matrix& matrix, const Path& path) -> void
             std::cout << free;
         }
 
-        for (auto x{ 0 }; x < matrix[y].size(); ++x)
+        for (auto x{ 0 }; x < matrix.columns(); ++x)
         {
             auto found{ false };
             for (auto&& coordinate : path)
@@ -267,15 +555,15 @@ auto Maze::print(const Matrix& matrix, const Path& path) -> void
                 std::cout << free;
             }
 
-            if (matrix[y][x].down and matrix[y][x].right)
+            if (matrix.down(y, x) and matrix.right(y, x))
             {
                 std::cout << square;
             }
-            else if (matrix[y][x].down)
+            else if (matrix.down(y, x))
             {
                 std::cout << free;
             }
-            else if (matrix[y][x].right)
+            else if (matrix.right(y, x))
             {
                 std::cout << square;
             }
@@ -289,17 +577,17 @@ auto Maze::print(const Matrix& matrix, const Path& path) -> void
 
         std::cout << square;
 
-        for (auto x{ 0 }; x < matrix[y].size(); ++x)
+        for (auto x{ 0 }; x < matrix.columns(); ++x)
         {
-            if (matrix[y][x].down && matrix[y][x].right)
+            if (matrix.down(y, x) && matrix.right(y, x))
             {
                 std::cout << square;
             }
-            else if (matrix[y][x].down)
+            else if (matrix.down(y, x))
             {
                 std::cout << square;
             }
-            else if (matrix[y][x].right)
+            else if (matrix.right(y, x))
             {
                 std::cout << free;
             }
@@ -319,17 +607,17 @@ auto Maze::lines(const Matrix& matrix, float height, float width) -> std::vector
 {
     auto lines{ std::vector<Line>{} };
 
-    const auto tileHeight{ height / matrix.size() };
-    const auto tileWidth{ width / matrix.front().size() };
+    const auto tileHeight{ height / matrix.rows() };
+    const auto tileWidth{ width / matrix.columns() };
 
     {
         auto make{ [&](float y, float currentHeight, bool Tile::* direction)
         {
             auto start{ 0.0f };
             auto end{ 0.0f };
-            for (auto x{ 0 }; x < matrix.front().size(); x++)
+            for (auto x{ 0 }; x < matrix.columns(); x++)
             {
-                if (matrix[y][x].*direction)
+                if (matrix.tile(static_cast<int>(y), static_cast<int>(x)).*direction)
                 {
                     end += tileWidth;
                 }
@@ -351,7 +639,7 @@ auto Maze::lines(const Matrix& matrix, float height, float width) -> std::vector
 
         make(0.0f, 0.0f, &Tile::up);
 
-        for (auto y{ 0 }; y < matrix.size(); y++)
+        for (auto y{ 0 }; y < matrix.rows(); y++)
         {
             make(y, (y + 1.0f) * tileHeight, &Tile::down);
         }
@@ -362,9 +650,9 @@ auto Maze::lines(const Matrix& matrix, float height, float width) -> std::vector
         {
             auto start{ 0.0f };
             auto end{ 0.0f };
-            for (auto y{ 0 }; y < matrix.size(); y++)
+            for (auto y{ 0 }; y < matrix.rows(); y++)
             {
-                if (matrix[y][x].*direction)
+                if (matrix.tile(static_cast<int>(y), static_cast<int>(x)).*direction)
                 {
                     end += tileHeight;
                 }
@@ -386,7 +674,7 @@ auto Maze::lines(const Matrix& matrix, float height, float width) -> std::vector
 
         make(0.0f, 0.0f, &Tile::left);
 
-        for (auto x{ 0 }; x < matrix.front().size(); x++)
+        for (auto x{ 0 }; x < matrix.columns(); x++)
         {
             make(x, (x + 1.0f) * tileWidth, &Tile::right);
         }
@@ -420,10 +708,11 @@ auto Maze::polygons(const Matrix& matrix, float x, float y, float width, float h
     return polygons;
 }
 
-Maze::Maze(b2World* world, b2Body* ground, size_t columns, size_t rows, float x, float y, float width, float height)
+Maze::Maze(b2World* world, b2Body* ground, size_t columns, size_t rows, float x, float y, float width, float height, Layout layout)
 {
     this->world = world;
     this->ground = ground;
+    this->layout = layout;
     this->x = x;
     this->y = y;
     this->height = height;
@@ -438,6 +727,7 @@ Maze::Maze(const Maze& other)
 {
     this->world = other.world;
     this->ground = other.ground;
+    this->layout = other.layout;
     this->x = other.x;
     this->y = other.y;
     this->height = other.height;
@@ -453,9 +743,15 @@ Maze::~Maze()
     this->world->DestroyBody(this->body);
 }
 
-auto Maze::randomize() -> void
+// Once its car is done the walls only need drawing, so they leave the broadphase the other cars query
+auto Maze::finish() -> void
 {
-    this->matrix = Maze::make(this->rows(), this->columns());
+    this->body->SetEnabled(false);
+}
+
+auto Maze::randomize(std::optional<uint32_t> seed, Generator generator) -> void
+{
+    this->matrix = Maze::make(this->rows(), this->columns(), seed, generator);
     this->createBody();
 }
 
@@ -469,90 +765,64 @@ auto Maze::createBody() -> void
     b2BodyDef bd{};
     bd.type = b2_staticBody;
     bd.position = b2Vec2{ this->x, this->y };
-    bd.userData = const_cast<char*>("maze");
+    bd.userData = Fixture::tag(Fixture::Kind::MAZE);
 
     this->body = this->world->CreateBody(&bd);
 
-    this->height = height;
-    this->width = width;
-    this->tileHeight = height / 3;
-    this->tileWidth = width / 3;
-    //this->matrix = Maze::make(this->rows(), this->columns());
+    if (this->layout == Layout::GENERATED)
+    {
+        this->tileHeight = this->height / this->rows();
+        this->tileWidth = this->width / this->columns();
+        this->createWalls();
+    }
+    else
+    {
+        this->tileHeight = this->height / 3;
+        this->tileWidth = this->width / 3;
 
-    { // Fixed Path
-        const auto thickness{ 0.015f };
-        const auto height{ 1.0f };
-        const auto width{ 1.5f };
-        const auto segment{ 0.5f };
+        { // Fixed Path
+            const auto thickness{ 0.015f };
+            const auto height{ 1.0f };
+            const auto width{ 1.5f };
+            const auto segment{ 0.5f };
 
-        b2PolygonShape shape{};
+            b2PolygonShape shape{};
 
-        b2FixtureDef fd{};
-        fd.shape = &shape;
-        fd.density = 0.0f;
-        fd.filter.categoryBits = 0x0001;
-        fd.filter.maskBits = 0x0003;
-        fd.userData = const_cast<char*>("wall");
+            b2FixtureDef fd{};
+            fd.shape = &shape;
+            fd.density = 0.0f;
+            fd.filter.categoryBits = 0x0001;
+            fd.filter.maskBits = 0x0003;
+            fd.userData = Fixture::tag(Fixture::Kind::WALL);
 
-        { // External
+            { // External
 
-            shape.SetAsBox(thickness / 2, height / 2, { 0, height / 2 }, 0);
-            this->body->CreateFixture(&fd);
+                shape.SetAsBox(thickness / 2, height / 2, { 0, height / 2 }, 0);
+                this->body->CreateFixture(&fd);
 
-            shape.SetAsBox(thickness / 2, height / 2, { width, height / 2 }, 0);
-            this->body->CreateFixture(&fd);
+                shape.SetAsBox(thickness / 2, height / 2, { width, height / 2 }, 0);
+                this->body->CreateFixture(&fd);
 
-            shape.SetAsBox(width / 2, thickness / 2, { width / 2, 0 }, 0);
-            this->body->CreateFixture(&fd);
+                shape.SetAsBox(width / 2, thickness / 2, { width / 2, 0 }, 0);
+                this->body->CreateFixture(&fd);
 
-            shape.SetAsBox(width / 2, thickness / 2, { width / 2, height }, 0);
-            this->body->CreateFixture(&fd);
-        }
+                shape.SetAsBox(width / 2, thickness / 2, { width / 2, height }, 0);
+                this->body->CreateFixture(&fd);
+            }
 
-        { // Segment
-            shape.SetAsBox(thickness / 2, segment / 2, { 1.17f, height - segment / 2 }, 0);
-            this->body->CreateFixture(&fd);
+            { // Segment
+                shape.SetAsBox(thickness / 2, segment / 2, { 1.17f, height - segment / 2 }, 0);
+                this->body->CreateFixture(&fd);
 
-            shape.SetAsBox(thickness / 2, segment / 2, { 0.84f, segment / 2 }, 0);
-            this->body->CreateFixture(&fd);
+                shape.SetAsBox(thickness / 2, segment / 2, { 0.84f, segment / 2 }, 0);
+                this->body->CreateFixture(&fd);
 
-            shape.SetAsBox(segment / 2, thickness / 2, { 0.84f - segment / 2, segment }, 0);
-            this->body->CreateFixture(&fd);
+                shape.SetAsBox(segment / 2, thickness / 2, { 0.84f - segment / 2, segment }, 0);
+                this->body->CreateFixture(&fd);
+            }
         }
     }
 
-    /*
-    this->matrix = { 
-        {{{1,0,1,1},{1,0,1,0},{1,0,0,1}}},
-        {{{0,0,1,1},{0,0,1,1},{0,0,1,1}}},
-        {{{0,1,1,0 },{0,1,0,1 },{0,1,1,1 }}}
-    };
-
-    //this->matrix = {
-    //    {{{1,0,1,1}, {1,0,1,1}, {1,0,1,1}}},
-    //    {{{0,0,1,1}, {0,0,1,1}, {0,0,1,1}}},
-    //    {{{0,1,1,0}, {0,1,0,0}, {0,1,0,1}}}
-    //};
-
-
-    const auto polygons{ Maze::polygons(this->matrix, 0, 0, this->width, this->height, 0.03f) };
-    for (const auto& poly : polygons)
-    {
-        b2PolygonShape shape{};
-    
-        b2FixtureDef fd{};
-        fd.shape = &shape;
-        fd.density = 0.0f;
-        fd.restitution = 0.1f;
-        fd.filter.categoryBits = 0x0001;
-        fd.filter.maskBits = 0x0003;
-        fd.userData = const_cast<char*>("wall");
-    
-        shape.Set(reinterpret_cast<const b2Vec2*>(poly.vertices.data()), poly.vertices.size());
-        this->body->CreateFixture(&fd);
-    }
-    */
-
     { // Start & End
         b2CircleShape shape{};
 
@@ -562,19 +832,47 @@ auto Maze::createBody() -> void
         fd.filter.categoryBits = 0x0002;
         fd.filter.maskBits = 0x0001;
 
-        //shape.m_radius = std::min(this->tileHeight, this->tileWidth) / 4;
-        shape.m_radius = 0.1f;
+        shape.m_radius = this->layout == Layout::GENERATED ? std::min(this->tileHeight, this->tileWidth) / 4 : 0.1f;
 
         shape.m_p = this->startPoint();
         shape.m_p -= { this->x, this->y };
-        fd.userData = const_cast<char*>("start");
+        fd.userData = Fixture::tag(Fixture::Kind::START);
         this->start = this->body->CreateFixture(&fd);
 
         shape.m_p = this->endPoint();
         shape.m_p -= { this->x, this->y };
-        fd.userData = const_cast<char*>("end");
+        fd.userData = Fixture::tag(Fixture::Kind::END);
         this->end = this->body->CreateFixture(&fd);
     }
+
+    // Seeded from wherever the end sensor landed, which on the fixed track is not the corner tile
+    this->distances = Maze::field(this->matrix, this->goal());
+
+    // Static geometry, only rebuilt when the body is
+    this->mesh = std::make_shared<const Draw::Mesh>(Draw::build(this->body));
+}
+
+// One box per maximal run of wall along a row or column boundary, rather than one per tile side,
+// so a maze holds a few fixtures per row and column instead of a few per cell
+auto Maze::createWalls() -> void
+{
+    const auto thickness{ 0.015f };
+
+    b2PolygonShape shape{};
+
+    b2FixtureDef fd{};
+    fd.shape = &shape;
+    fd.density = 0.0f;
+    fd.filter.categoryBits = 0x0001;
+    fd.filter.maskBits = 0x0003;
+    fd.userData = Fixture::tag(Fixture::Kind::WALL);
+
+    for (const auto& line : Maze::lines(this->matrix, this->height, this->width))
+    {
+        const auto center{ b2Vec2{ (line.x0 + line.x1) / 2, (line.y0 + line.y1) / 2 } };
+        shape.SetAsBox((line.x1 - line.x0 + thickness) / 2, (line.y1 - line.y0 + thickness) / 2, center, 0);
+        this->body->CreateFixture(&fd);
+    }
 }
 
 auto Maze::step() -> void
@@ -582,19 +880,28 @@ auto Maze::step() -> void
     // Nada
 }
 
-auto Maze::render(GPU_Target* target) const -> void
+auto Maze::snapshot(Snapshot::Static& snapshot) const -> void
 {
-    GPU_SetLineThickness(0.01f);
-    
-    Draw::draw(target, this->body);
+    snapshot.bounds = this->bounds();
+    snapshot.mesh = this->mesh;
+}
+
+auto Maze::bounds() const -> b2AABB
+{
+    auto aabb{ b2AABB{} };
+    aabb.lowerBound = b2Vec2{ this->x, this->y };
+    aabb.upperBound = b2Vec2{ this->x + this->width, this->y + this->height };
+    return aabb;
 }
 
 auto Maze::solve(const b2Vec2& point, bool bestSolution) const->std::vector<b2Vec2>
 {
+    const auto scope{ Profiler::Scope{ Profiler::Phase::SOLVE } };
+
     auto path{ std::vector<b2Vec2>{} };
 
     const auto coordinate{ this->toLocalCoordinate(point) };
-    if (coordinate.x < 0 or coordinate.y < 0 or coordinate.y >= matrix.size() or coordinate.x >= matrix.front().size())
+    if (coordinate.x < 0 or coordinate.y < 0 or coordinate.y >= matrix.rows() or coordinate.x >= matrix.columns())
     {
         return {};
     }
@@ -604,7 +911,7 @@ auto Maze::solve(const b2Vec2& point, bool bestSolution) const->std::vector<b2Ve
     auto rd{ std::random_device{} };
     auto mt{ std::mt19937{rd()} };
 
-    const auto solution{ Maze::solve(this->matrix, coordinate.y, coordinate.x, bestSolution) };
+    const auto solution{ bestSolution ? Maze::descend(this->matrix, this->distances, coordinate.y, coordinate.x) : Maze::solve(this->matrix, coordinate.y, coordinate.x, false, this->goal()) };
     for (auto&& coordinate : solution)
     {
         //auto dist{ std::uniform_real_distribution<float>{ -0.075f, +0.075f } };
@@ -619,6 +926,30 @@ auto Maze::solve(const b2Vec2& point, bool bestSolution) const->std::vector<b2Ve
     return path;
 }
 
+// Along the maze rather than straight through its walls: the steps left from the current tile plus the way to its center.
+// Only generated walls follow the matrix, the fixed track gets the straight line to its end
+auto Maze::distance(const b2Vec2& point) const -> float
+{
+    const auto coordinate{ this->toLocalCoordinate(point) };
+    if (this->layout != Layout::GENERATED or coordinate.x < 0 or coordinate.y < 0 or coordinate.y >= this->rows() or coordinate.x >= this->columns())
+    {
+        return b2Distance(point, this->endPoint());
+    }
+
+    const auto steps{ this->distances[this->matrix.index(coordinate.y, coordinate.x)] };
+    if (steps == Maze::unreachable)
+    {
+        return b2Distance(point, this->endPoint());
+    }
+
+    return steps * (this->tileWidth + this->tileHeight) / 2.0f + b2Distance(point, this->toRealPoint(coordinate));
+}
+
+auto Maze::goal() const->Coordinate
+{
+    return this->toLocalCoordinate(this->endPoint());
+}
+
 auto Maze::toLocalCoordinate(const b2Vec2& point) const->Coordinate
 {
     const auto y{ static_cast<int>( ( point.y - this->y ) / this->tileHeight ) };
@@ -637,10 +968,10 @@ auto Maze::toRealPoint(const Coordinate& coordinate) const->b2Vec2
 
 auto Maze::rows() const->size_t
 {
-    return this->matrix.size();
+    return this->matrix.rows();
 }
 
 auto Maze::columns() const->size_t
 {
-    return ( this->matrix.empty() ? 0 : this->matrix.front().size() );
+    return this->matrix.columns();
 }
\ No newline at end of file
@@ -5,15 +5,18 @@
 
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <array>
+
+#include "..\Draw.hpp"
+#include "Snapshot.hpp"
+#include "Grid.hpp"
 
 class Maze
 {
 public:
-    struct Tile
-    {
-        bool up, down;
-        bool left, right;
-    };
+    using Tile = Grid::Tile;
 
     struct Point
     {
@@ -36,34 +39,75 @@ public:
         int x, y;
     };
 
-    using Matrix = std::vector<std::vector<Tile>>;
+    // Recursive backtracker gives long winding corridors, Eller streams row by row in memory proportional to the width,
+    // Kruskal many short dead ends, Wilson a uniform pick among all perfect mazes and braid loops without dead ends
+    enum class Generator
+    {
+        BACKTRACKER,
+        ELLER,
+        KRUSKAL,
+        WILSON,
+        BRAID
+    };
+
+    static constexpr std::array<const char*, 5> generatorNames{ "backtracker", "eller", "kruskal", "wilson", "braid" };
+
+    // The hand built test track, or walls built from the generated matrix
+    enum class Layout
+    {
+        FIXED,
+        GENERATED
+    };
+
+    static constexpr std::array<const char*, 2> layoutNames{ "fixed", "generated" };
+
+    using Matrix = Grid;
     using Path = std::vector<Coordinate>;
+    using Field = std::vector<uint32_t>;
 
-    Maze(b2World* world, b2Body* ground, size_t columns, size_t rows, float x, float y, float width, float height);
+    Maze(b2World* world, b2Body* ground, size_t columns, size_t rows, float x, float y, float width, float height, Layout layout = Layout::FIXED);
     Maze(const Maze& other);
     ~Maze();
 
     auto step() -> void;
-    auto render(GPU_Target* target) const -> void;
+    auto finish() -> void;
+    auto snapshot(Snapshot::Static& snapshot) const -> void;
+    auto bounds() const -> b2AABB;
 
     auto solve(const b2Vec2& point, bool bestSolution = true) const->std::vector<b2Vec2>;
+    auto distance(const b2Vec2& point) const -> float;
 
     auto startPoint() const -> b2Vec2;
     auto endPoint() const -> b2Vec2;
     auto isOnStart(const b2Vec2& point) const -> bool;
     auto isOnEnd(const b2Vec2& point) const -> bool;
+    auto isSameTile(const b2Vec2& a, const b2Vec2& b) const -> bool;
 
-    auto randomize() -> void;
+    // The same seed always carves the same maze
+    auto randomize(std::optional<uint32_t> seed = std::nullopt, Generator generator = Generator::BACKTRACKER) -> void;
+
+    static auto make(size_t rows, size_t columns, std::optional<uint32_t> seed = std::nullopt, Generator generator = Generator::BACKTRACKER)->Matrix;
+    static auto solve(const Matrix& matrix, int y, int x, bool bestSolution = true, Coordinate goal = { 0, 0 })->Path;
+    static auto field(const Matrix& matrix, Coordinate goal = { 0, 0 })->Field;
+    static auto descend(const Matrix& matrix, const Field& field, int y, int x)->Path;
+
+    static constexpr uint32_t unreachable{ UINT32_MAX };
 
 private:
     auto createBody() -> void;
+    auto createWalls() -> void;
+    auto goal() const->Coordinate;
     auto toLocalCoordinate(const b2Vec2& point) const->Coordinate;
     auto toRealPoint(const Coordinate& coordinate) const->b2Vec2;
     auto rows() const->size_t;
     auto columns() const->size_t;
 
-    static auto make(size_t rows, size_t columns)->Matrix;
-    static auto solve(const Matrix& matrix, int y, int x, bool bestSolution = true)->Path;
+    static auto backtracker(size_t rows, size_t columns, uint32_t seed)->Matrix;
+    static auto eller(size_t rows, size_t columns, uint32_t seed)->Matrix;
+    static auto kruskal(size_t rows, size_t columns, uint32_t seed)->Matrix;
+    static auto wilson(size_t rows, size_t columns, uint32_t seed)->Matrix;
+    static auto braid(size_t rows, size_t columns, uint32_t seed)->Matrix;
+
     static auto lines(const Matrix& matrix, float height, float width)->std::vector<Line>;
     static auto polygons(const Matrix& matrix, float x, float y, float height, float width, float thickness)->std::vector<Polygon>;
     static auto print(const Matrix& matrix, const Path& path = {}) -> void;
@@ -73,6 +117,7 @@ private:
     b2Body* body{ nullptr };
     b2Fixture* start{ nullptr };
     b2Fixture* end{ nullptr };
+    Layout layout{ Layout::FIXED };
    
     float x{ 0.0f };
     float y{ 0.0f };
@@ -81,6 +126,8 @@ private:
     float tileWidth{ 0.0f };
     float tileHeight{ 0.0f };
     Matrix matrix{};
+    Field distances{}; // steps from every cell to the one holding the end sensor, rebuilt with the body
+    std::shared_ptr<const Draw::Mesh> mesh{};
     
     static constexpr SDL_Color backgroundColor{ 0, 0, 0, 255 };
     static constexpr SDL_Color fontColor{ 0, 255, 0, 255 };
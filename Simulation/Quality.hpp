@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <box2d/box2d.h>
+
+#include "Window.hpp"
+#include "..\Profiler.hpp"
+
+// How carefully Box2D integrates one tick: solver iterations, sub-steps of Window::timeStep and continuous collision
+namespace Quality
+{
+    struct Profile
+    {
+        const char* name;
+        int velocityIterations;
+        int positionIterations;
+        int subSteps;
+        bool continuous;
+    };
+
+    // REPLAY, where the car has to track the capture closely
+    static constexpr Profile precise{ "precise", 8, 3, 2, true };
+    // Everything interactive, what world.Step(Window::timeStep, 4, 4) always did
+    static constexpr Profile standard{ "standard", 4, 4, 1, true };
+    // Follower data generation, one velocity and position pass is enough for cars driven by setting their velocity
+    static constexpr Profile fast{ "fast", 2, 1, 1, false };
+
+    // Largest drop in follower success rate, against standard, that fast may cost
+    static constexpr float tolerance{ 0.02f };
+
+    // Where --evaluate leaves its follower check, the simulator only generates data on fast once it has passed
+    static constexpr auto checkPath{ R"(C:\Users\Giovanni\Desktop\auto2\scripts\quality.csv)" };
+
+    // A run where the follower never finished on standard proves nothing, so it fails the check
+    static auto check(int episodes, int standardSuccesses, int fastSuccesses) -> bool
+    {
+        const auto loss{ static_cast<float>(standardSuccesses - fastSuccesses) / std::max(episodes, 1) };
+        const auto within{ standardSuccesses > 0 and loss <= Quality::tolerance };
+
+        auto ofs{ std::ofstream{ Quality::checkPath } };
+        ofs << "episodes;standard;fast;loss;within\n"
+            << episodes << ';' << standardSuccesses << ';' << fastSuccesses << ';' << loss << ';' << within << '\n';
+        return within;
+    }
+
+    static auto isChecked() -> bool
+    {
+        auto ifs{ std::ifstream{ Quality::checkPath } };
+        auto header{ std::string{} };
+        auto row{ std::string{} };
+        if (not std::getline(ifs, header) or not std::getline(ifs, row))
+        {
+            return false;
+        }
+        return not row.empty() and row.back() == '1';
+    }
+
+    // The tick still advances Window::timeStep, so controllers and captures see the same rate whatever the profile
+    static auto step(b2World& world, const Profile& profile) -> void
+    {
+        world.SetContinuousPhysics(profile.continuous);
+
+        const auto timeStep{ Window::timeStep / profile.subSteps };
+        for (auto n{ 0 }; n < profile.subSteps; ++n)
+        {
+            world.Step(timeStep, profile.velocityIterations, profile.positionIterations);
+            Profiler::record(world.GetProfile());
+        }
+    }
+}
@@ -4,24 +4,47 @@
 #include <thread>
 #include <future>
 #include <chrono>
+#include <array>
+#include <mutex>
+#include <numeric>
 
 #include "Simulation.hpp"
 #include "Follower.hpp"
+#include "..\Profiler.hpp"
 
 
 #include "..\Neural.hpp"
 
 auto Simulation::reset() -> void
 {
-	this->neural = std::make_unique<Neural>(R"(C:\Users\Giovanni\Desktop\auto2\scripts\models\model_simulation_18s_20x_48x48x48)");
+	this->fastChecked = Quality::isChecked();
+	this->neural = std::make_unique<Neural>(this->neuralPath);
 	this->fuzzy = std::make_unique<Fuzzy>(R"(C:\Users\Giovanni\Desktop\auto2\fuzzy.fll)");
-	this->replay = std::make_unique<Replay>(&world, ground, b2Vec2{ 3, 1 }, R"(D:\Google Drive\TCC SENAI\Capturas\simulation_capture_6s_20x_1,5x1m.csv)");
+	if (this->noise == nullptr and std::filesystem::exists(R"(C:\Users\Giovanni\Desktop\auto2\scripts\noise.csv)"))
+	{
+		this->noise = std::make_unique<Noise>(R"(C:\Users\Giovanni\Desktop\auto2\scripts\noise.csv)");
+	}
+	this->replays.clear();
+	{
+		const auto filePaths{ Replay::captures(R"(C:\Users\Giovanni\Desktop\auto2\scripts)") };
+		const auto [squareHeight, squareWidth] { Simulation::grid(static_cast<int>(filePaths.size())) };
+
+		this->replays.reserve(filePaths.size());
+		for (auto n{ 0 }; n < filePaths.size(); ++n)
+		{
+			const auto j{ n / squareWidth };
+			const auto i{ n % squareWidth };
+			this->replays.emplace_back(std::make_unique<Replay>(&replayWorld, replayGround, b2Vec2{ 1 + i * (Replay::width + 0.2f), 1 + j * (Replay::height + 0.2f) }, filePaths[n], Simulation::dynamics == Car::Dynamics::DYNAMIC));
+		}
+	}
 
 	this->mazes.clear();
 	this->cars.clear();
 	this->followers.clear();
 
 	this->done = 0;
+	this->active.resize(quantity);
+	std::iota(this->active.begin(), this->active.end(), 0);
 
 	constexpr auto rows{ 3 };
 	constexpr auto columns{ 3 };
@@ -33,23 +56,17 @@ auto Simulation::reset() -> void
 		this->cars.reserve(quantity);
 		this->followers.reserve(quantity);
 
-		auto squareHeight{ static_cast<int>(std::sqrt(quantity)) };
-		auto squareWidth{ quantity / squareHeight };
-		while (squareHeight * squareWidth != quantity)
-		{
-			--squareHeight;
-			squareWidth = quantity / squareHeight;
-		}
+		const auto [squareHeight, squareWidth] { Simulation::grid(quantity) };
 
 		for (auto j{ 0 }; j < squareHeight; ++j)
 		{
 			for (auto i{ 0 }; i < squareWidth; ++i)
 			{
-				auto& maze{ this->mazes.emplace_back(&world, ground, columns, rows, 1 + i * (width + 0.2f), 3 + j * (height + 0.2f), width, height) };
+				auto& maze{ this->mazes.emplace_back(&world, ground, columns, rows, 1 + i * (width + 0.2f), 3 + j * (height + 0.2f), width, height, this->layout) };
 
-				maze.randomize();
+				maze.randomize(std::nullopt, this->generator);
 
-				auto& car{ this->cars.emplace_back(&world, ground, maze.startPoint()) };
+				auto& car{ this->cars.emplace_back(&world, ground, maze.startPoint(), this->noise.get(), Simulation::dynamics) };
 
 				const auto solution{ maze.solve(car.position(), true) };
 
@@ -57,426 +74,760 @@ auto Simulation::reset() -> void
 			}
 		}
 	}
-
-	//this->nets.front() = clone(this->base);
 }
 
 auto Simulation::init() -> void
 {
 	this->window.init(Simulation::realWidth, Simulation::realHeight);
 	this->ground = this->createGround(&world);
+	this->replayGround = this->createGround(&replayWorld);
 	
 	this->reset();
 
+	// The window only forwards the keyboard, everything else happens on the simulation thread
 	window.onKeyboard([&](const uint8_t* state) -> void
 		{
-			this->move = Move::STOP;
+			const auto lock{ std::lock_guard<std::mutex>{ this->keyboardMutex } };
+			std::copy_n(state, this->keyboard.size(), this->keyboard.begin());
+		});
+
+	window.onRender([&](GPU_Target* target, const Window::View& view)
+		{
+			this->render(target, view);
+		});
 
-			if (state[SDL_SCANCODE_A])
+	window.onInfos([&](std::ostringstream& oss)
+		{
+			if (this->shown != nullptr)
 			{
-				this->move = Move::ROTATE_LEFT;
+				oss << this->shown->infos;
 			}
-			else if (state[SDL_SCANCODE_D])
+		});
+
+	this->running = true;
+	this->simulationThread = std::thread{ [this] { this->run(); } };
+
+	window.process();
+
+	this->running = false;
+	this->simulationThread.join();
+}
+
+auto Simulation::run() -> void
+{
+	auto state{ std::array<uint8_t, SDL_NUM_SCANCODES>{} };
+	auto next{ std::chrono::steady_clock::now() };
+
+	while (this->running)
+	{
+		{
+			const auto lock{ std::lock_guard<std::mutex>{ this->keyboardMutex } };
+			state = this->keyboard;
+		}
+
+		this->input(state.data());
+		this->tick();
+		this->publish();
+
+		// Fixed tick rate, without trying to catch up after a stall
+		next = std::max(next + std::chrono::milliseconds{ static_cast<int>(Window::tickStep) }, std::chrono::steady_clock::now());
+		std::this_thread::sleep_until(next);
+	}
+}
+
+auto Simulation::input(const uint8_t* state) -> void
+{
+	this->move = Move::STOP;
+
+	if (state[SDL_SCANCODE_A])
+	{
+		this->move = Move::ROTATE_LEFT;
+	}
+	else if (state[SDL_SCANCODE_D])
+	{
+		this->move = Move::ROTATE_RIGHT;
+	}
+	else if (state[SDL_SCANCODE_W])
+	{
+		this->move = Move::MOVE_FORWARD;
+	}
+	else if (state[SDL_SCANCODE_S])
+	{
+		this->move = Move::MOVE_BACKWARD;
+	}
+
+	if (state[SDL_SCANCODE_F1])
+	{
+		if (not resetChanged)
+		{
+			this->resetChanged = true;
+
+			this->mode = Mode::STOPPED;
+			this->control = Control::MANUAL;
+			this->data = Data::IDLE;
+			this->current = 0;
+
+			this->reset();
+		}
+	}
+	else
+	{
+		this->resetChanged = false;
+	}
+
+	if (state[SDL_SCANCODE_F2])
+	{
+		if (not controlChanged)
+		{
+			this->controlChanged = true;
+
+			if (this->control == Control::MANUAL)
 			{
-				this->move = Move::ROTATE_RIGHT;
+				this->control = Control::AUTO;
+
+				for (auto n{ 0 }; n < this->cars.size(); ++n)
+				{
+					const auto solution{ this->mazes[n].solve(this->cars[n].position(), false) };
+					this->followers[n] = { &this->cars[n], solution };
+				}
 			}
-			else if (state[SDL_SCANCODE_W])
+			else if (this->control == Control::AUTO)
 			{
-				this->move = Move::MOVE_FORWARD;
+				this->control = Control::NEURAL;
 			}
-			else if (state[SDL_SCANCODE_S])
+			else if (this->control == Control::NEURAL)
 			{
-				this->move = Move::MOVE_BACKWARD;
+				this->control = Control::FUZZY;
 			}
-
-			if (state[SDL_SCANCODE_F1])
+			else if (this->control == Control::FUZZY)
 			{
-				if (not resetChanged)
-				{
-					this->resetChanged = true;
+				this->control = Control::EVOLUTION;
 
-					this->mode = Mode::STOPPED;
-					this->control = Control::MANUAL;
-					this->data = Data::IDLE;
-					this->current = 0;
-
-					this->reset();
+				if (this->evolution == nullptr)
+				{
+					this->evolution = std::make_unique<Evolution>(std::vector<int>{ 18, 48, 48, 48, 5 }, 64, this->noise.get(), Simulation::dynamics, this->layout, this->generator);
+				}
+				if (not this->evolutionTask.valid())
+				{
+					this->evolutionTask = std::async(std::launch::async, [this] { this->evolution->generation(); });
 				}
 			}
-			else
+			else if (this->control == Control::EVOLUTION)
 			{
-				this->resetChanged = false;
-			}
+				this->control = Control::DAGGER;
 
-			if (state[SDL_SCANCODE_F2])
+				this->beta = 1.0f;
+				this->rounds = 0;
+				this->trained = 0;
+				this->daggerFeatures.clear();
+				this->daggerLabels.clear();
+			}
+			else if (this->control == Control::DAGGER)
 			{
-				if (not controlChanged)
-				{
-					this->controlChanged = true;
+				this->control = Control::REPLAY;
+			}
+			else if (this->control == Control::REPLAY)
+			{
+				this->control = Control::MANUAL;
+			}
+		}
+	}
+	else
+	{
+		this->controlChanged = false;
+	}
 
-					if (this->control == Control::MANUAL)
-					{
-						this->control = Control::AUTO;
+	if (state[SDL_SCANCODE_F3])
+	{
+		if (not dataChanged)
+		{
+			this->dataChanged = true;
 
-						for (auto n{ 0 }; n < this->cars.size(); ++n)
-						{
-							const auto solution{ this->mazes[n].solve(this->cars[n].position(), false) };
-							this->followers[n] = { &this->cars[n], solution };
-						}
-					}
-					else if (this->control == Control::AUTO)
-					{
-						this->control = Control::NEURAL;
-					}
-					else if (this->control == Control::NEURAL)
-					{
-						this->control = Control::FUZZY;
-					}
-					else if (this->control == Control::FUZZY)
-					{
-						this->control = Control::REPLAY;
-					}
-					else if (this->control == Control::REPLAY)
-					{
-						this->control = Control::MANUAL;
-					}
-				}
+			// DAGGER labels into its own aggregate, there is nothing for F3 to record
+			if (this->data == Data::IDLE and this->control != Control::DAGGER)
+			{
+				this->data = Data::GENERATING;
 			}
-			else
+			else if (this->data == Data::GENERATING)
 			{
-				this->controlChanged = false;
+				this->generationTask = this->generateCSV();
+				this->data = Data::SAVING;
 			}
-
-			if (state[SDL_SCANCODE_F3])
+			else if (this->data == Data::SAVING or this->data == Data::TRAINING)
 			{
-				if (not dataChanged)
-				{
-					this->dataChanged = true;
-
-					if (this->data == Data::IDLE)
-					{
-						this->data = Data::GENERATING;
-					}
-					else if (this->data == Data::GENERATING)
-					{
-						this->generationTask = this->generateCSV();
-						this->data = Data::SAVING;
-					}
-					else if (this->data == Data::SAVING)
-					{
-						// Nothing
-					}
-					else if (this->data == Data::DONE)
-					{
-						// Nothing
-					}
-				}
+				// Nothing
 			}
-			else
+			else if (this->data == Data::DONE)
 			{
-				this->dataChanged = false;
+				// Nothing
 			}
+		}
+	}
+	else
+	{
+		this->dataChanged = false;
+	}
+
+	if (state[SDL_SCANCODE_F4])
+	{
+		if (not modeChanged)
+		{
+			this->modeChanged = true;
 
-			if (state[SDL_SCANCODE_F4])
+			if (this->mode == Mode::STOPPED)
 			{
-				if (not modeChanged)
-				{
-					this->modeChanged = true;
+				this->mode = Mode::PLAYING;
+			}
+			else if (this->mode == Mode::PLAYING)
+			{
+				this->mode = Mode::STOPPED;
+			}
+		}
+	}
+	else
+	{
+		this->modeChanged = false;
+	}
 
-					if (this->mode == Mode::STOPPED)
-					{
-						this->mode = Mode::PLAYING;
-					}
-					else if (this->mode == Mode::PLAYING)
-					{
-						this->mode = Mode::STOPPED;
-					}
-				}
+	if (state[SDL_SCANCODE_F5])
+	{
+		if (not traceChanged)
+		{
+			this->traceChanged = true;
+
+			if (Profiler::isTracing())
+			{
+				Profiler::trace(false);
+				Profiler::save(R"(C:\Users\Giovanni\Desktop\auto2\scripts\trace.json)");
 			}
 			else
 			{
-				this->modeChanged = false;
+				Profiler::trace(true);
 			}
+		}
+	}
+	else
+	{
+		this->traceChanged = false;
+	}
 
-			//this->cars.front().doMove(this->move);
-		});
+	if (state[SDL_SCANCODE_F6])
+	{
+		if (not layoutChanged)
+		{
+			this->layoutChanged = true;
 
-	auto trained{ false };
+			this->layout = this->layout == Maze::Layout::FIXED ? Maze::Layout::GENERATED : Maze::Layout::FIXED;
+		}
+	}
+	else
+	{
+		this->layoutChanged = false;
+	}
 
+	if (state[SDL_SCANCODE_F7])
+	{
+		if (not generatorChanged)
+		{
+			this->generatorChanged = true;
 
-	window.onRender([&](GPU_Target* target)
+			const auto next{ (static_cast<int>(this->generator) + 1) % static_cast<int>(Maze::generatorNames.size()) };
+			this->generator = static_cast<Maze::Generator>(next);
+		}
+	}
+	else
+	{
+		this->generatorChanged = false;
+	}
+
+	//this->cars.front().doMove(this->move);
+}
+
+auto Simulation::tick() -> void
+{
+	const auto scope{ Profiler::Scope{ Profiler::Phase::TICK } };
+
+	if (mode == Mode::STOPPED)
+	{
+		// Nothing
+	}
+	else if (mode == Mode::PLAYING)
+	{
+		if (control == Control::MANUAL)
 		{
-			if (mode == Mode::STOPPED)
+			this->cars[0].doMove(this->move);
+
+			if (data == Data::GENERATING and this->move != Move::STOP)
 			{
-				// Nothing
+				auto inputs{ this->cars[0].inputs() };
+				this->features.emplace_back(inputs);
+
+				auto label{ std::vector<int>{} };
+				label.resize(5);
+				label[static_cast<int>(this->move)] = 1;
+
+				this->labels.emplace_back(label);
 			}
-			else if (mode == Mode::PLAYING)
+		}
+		else if (control == Control::AUTO)
+		{
+#pragma omp parallel for
+			for (auto k{ 0 }; k < this->active.size(); ++k)
+			{
+				this->followers[this->active[k]].step();
+			}
+
+			if (data == Data::GENERATING)
 			{
-				if (control == Control::MANUAL)
-				{
-					this->cars[0].doMove(this->move);
 
-					if (data == Data::GENERATING and this->move != Move::STOP)
+				for (const auto n : this->active)
+				{
+					if (not this->followers[n].isDone())
 					{
-						auto inputs{ Simulation::inputs(this->cars[0]) };
+						auto inputs{ this->cars[n].inputs() };
 						this->features.emplace_back(inputs);
 
 						auto label{ std::vector<int>{} };
 						label.resize(5);
-						label[static_cast<int>(this->move)] = 1;
+						label[static_cast<int>(this->followers[n].movement())] = 1;
 
 						this->labels.emplace_back(label);
 					}
 				}
-				else if (control == Control::AUTO)
-				{
+			}
+		}
+		else if (control == Control::NEURAL)
+		{
+
 #pragma omp parallel for
-					for (auto n{ 0 }; n < this->followers.size(); ++n)
-					{
-						this->followers[n].step();
-					}
+			for (auto k{ 0 }; k < this->active.size(); ++k)
+			{
+				const auto n{ this->active[k] };
+				const auto inputs{ this->cars[n].inputs() };
+				const auto outputs{ this->neural->inference(inputs) };
 
-					if (data == Data::GENERATING)
-					{
+				this->cars[n].doMove(Car::decide(outputs));
+			}
+		}
+		else if (control == Control::FUZZY)
+		{
+//#pragma omp parallel for
+			for (const auto n : this->active)
+			{
+				const auto inputs{ this->cars[n].inputs() };
+				const auto outputs{ this->fuzzy->inference(inputs) };
 
-						for (auto n{ 0 }; n < this->followers.size(); ++n)
-						{
-							if (not this->followers[n].isDone())
-							{
-								auto inputs{ Simulation::inputs(this->cars[n]) };
-								this->features.emplace_back(inputs);
+				this->cars[n].doMove(Car::decide(outputs));
+			}
+		}
+		else if (control == Control::EVOLUTION)
+		{
+			// Generations run headless in the background, the cars show the best network so far
+			if (this->evolutionTask.valid() and this->evolutionTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+			{
+				this->evolutionTask.get();
+				this->champion = std::make_unique<Network>(this->evolution->best());
 
-								auto label{ std::vector<int>{} };
-								label.resize(5);
-								label[static_cast<int>(this->followers[n].movement())] = 1;
+				auto oss{ std::ostringstream{} };
+				oss << "evolution = " << this->evolution->generations()
+					<< " (best " << this->evolution->bestFitness()
+					<< ", mean " << this->evolution->meanFitness() << ")";
+				this->evolutionStatus = oss.str();
 
-								this->labels.emplace_back(label);
-							}
-						}
-					}
-				}
-				else if (control == Control::NEURAL)
-				{
+				this->evolutionTask = std::async(std::launch::async, [this] { this->evolution->generation(); });
+			}
 
+			if (this->champion != nullptr)
+			{
 #pragma omp parallel for
-					for (auto n{ 0 }; n < this->cars.size(); ++n)
-					{
-						const auto inputs{ Simulation::inputs(this->cars[n]) };
-						const auto outputs{ this->neural->inference(inputs) };
-
-						auto max{ 0 };
-						for (auto n{ 1 }; n < outputs.size(); ++n)
-						{
-							if (std::abs(outputs[n]) > std::abs(outputs[max]))
-							{
-								max = n;
-							}
-						}
-
-						this->cars[n].doMove(static_cast<Move>(max));
-					}
-				}
-				else if (control == Control::FUZZY)
-				{
-//#pragma omp parallel for
-					for (auto n{ 0 }; n < this->cars.size(); ++n)
-					{
-						const auto inputs{ Simulation::inputs(this->cars[n]) };
-						const auto outputs{ this->fuzzy->inference(inputs) };
-
-						auto max{ 0 };
-						for (auto n{ 1 }; n < outputs.size(); ++n)
-						{
-							if (std::abs(outputs[n]) > std::abs(outputs[max]))
-							{
-								max = n;
-							}
-						}
-
-						this->cars[n].doMove(static_cast<Move>(max));
-					}
-				}
-				else if (control == Control::REPLAY)
+				for (auto k{ 0 }; k < this->active.size(); ++k)
 				{
-					this->replay->step();
-				}
+					const auto n{ this->active[k] };
+					const auto inputs{ this->cars[n].inputs() };
+					const auto outputs{ this->champion->inference(inputs) };
 
-				if (data == Data::SAVING)
-				{
-					if (this->generationTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
-					{
-						this->data = Data::DONE;
-						this->features.clear();
-						this->labels.clear();
-					}
+					this->cars[n].doMove(Car::decide(outputs));
 				}
+			}
+		}
+		else if (control == Control::DAGGER)
+		{
+			// The learner drives (mixed with the expert by beta) while the follower labels every visited state
+			if (this->daggerTask.valid() and this->daggerTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+			{
+				this->learner = std::make_unique<Network>(this->daggerTask.get());
+				this->beta *= 0.5f;
+				++this->rounds;
+			}
 
-				if (control == Control::MANUAL or control == Control::AUTO or control == Control::NEURAL or control == Control::FUZZY)
+			auto coin{ std::bernoulli_distribution{ this->beta } };
+			for (const auto n : this->active)
+			{
+				// One expert per car kept across ticks, a fresh one would only ever aim back at the centre of the current tile.
+				// It is planned again once the learner has pushed the car off the path left to drive
+				auto& follower{ this->followers[n] };
+				if (follower.isDone() or not follower.isOnPath(this->mazes[n]))
 				{
-					this->done = 0;
+					follower = Follower{ &this->cars[n], this->mazes[n].solve(this->cars[n].position(), true) };
+				}
+				const auto expert{ follower.expert() };
 
-#pragma omp parallel for
-					for (auto n{ 0 }; n < this->cars.size(); n++)
-					{
-						if (this->mazes[n].isOnEnd(this->cars[n].position()))
-						{
-#pragma omp atomic
-							++this->done;
-						}
-						else
-						{
-							this->cars[n].step();
-						}
-					}
+				const auto inputs{ this->cars[n].inputs() };
+				this->daggerFeatures.emplace_back(inputs);
 
-#pragma omp parallel for
-					for (auto n{ 0 }; n < this->mazes.size(); n++)
-					{
-						this->mazes[n].step();
-					}
-				}
+				auto label{ std::vector<int>{} };
+				label.resize(5);
+				label[static_cast<int>(expert)] = 1;
 
-				world.Step(Window::timeStep, 4, 4);
+				this->daggerLabels.emplace_back(label);
 
-				if (this->done == this->cars.size())
+				auto move{ expert };
+				if (this->learner != nullptr and not coin(this->mt))
 				{
-					if (this->current < this->generations)
-					{
-						++this->current;
-						this->reset();
-					}
-					else
-					{
-						this->control = Control::MANUAL;
-						
-						if (this->data == Data::GENERATING)
-						{
-							this->generationTask = this->generateCSV();
-							this->data = Data::SAVING;
-						}
-					}
+					move = Car::decide(this->learner->inference(inputs));
 				}
-			}
 
-			if (control == Control::AUTO)
-			{
-				for (auto n{ 0 }; n < this->followers.size(); ++n)
-				{
-					this->followers[n].render(target);
-				}
+				this->cars[n].doMove(move);
 			}
-			else if (control == Control::MANUAL or control == Control::NEURAL or control == Control::FUZZY)
-			{
-				for (auto n{ 0 }; n < this->cars.size(); n++)
-				{
-					this->cars[n].render(target);
-				}
 
-				for (auto n{ 0 }; n < this->mazes.size(); n++)
-				{
-					this->mazes[n].render(target);
-				}
-			}
-			else if (control == Control::REPLAY)
+			if (not this->daggerTask.valid() and this->daggerFeatures.size() >= this->trained + Simulation::daggerSamples)
 			{
-				this->replay->render(target);
+				this->trained = this->daggerFeatures.size();
+				this->daggerTask = this->train(this->daggerFeatures, this->daggerLabels);
 			}
-		});
-
-	window.onInfos([&](std::ostringstream& oss)
+		}
+		else if (control == Control::REPLAY)
 		{
-			//const auto distances{ this->cars.front().distances() };
-			//oss << "front = " << distances.at(0) << " m \n"
-			//    << "left = " << distances.at(+90) << " m \n"
-			//    << "right = " << distances.at(-90) << " m \n"
-			//    << "move = " << (move > 0 ? "+" : move < 0 ? "-" : "o") << " \n"
-			//    << "rotate = " << (rotate > 0 ? "+" : rotate < 0 ? "-" : "o") << " \n"
-			//    << "collided = " << this->cars.front().collided() << " \n";
-
-			oss << "[F1] Reset" << '\n';
-
-			oss << "[F2] Control = ";
-			if (this->control == Control::MANUAL)
-			{
-				oss << "MANUAL";
-			}
-			else if (this->control == Control::AUTO)
+#pragma omp parallel for
+			for (auto n{ 0 }; n < this->replays.size(); ++n)
 			{
-				oss << "AUTO";
+				this->replays[n]->step();
 			}
-			else if (this->control == Control::NEURAL)
+
+			Quality::step(replayWorld, this->quality());
+		}
+
+		if (data == Data::SAVING)
+		{
+			if (this->generationTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready and not this->trainingTask.valid())
 			{
-				oss << "NEURAL";
+				this->trainingTask = this->train(this->features, this->labels);
+				this->data = Data::TRAINING;
 			}
-			else if (this->control == Control::FUZZY)
+		}
+		else if (data == Data::TRAINING)
+		{
+			if (this->trainingTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
 			{
-				oss << "FUZZY";
+				this->data = Data::DONE;
+				this->features.clear();
+				this->labels.clear();
+
+				this->neuralPath = R"(C:\Users\Giovanni\Desktop\auto2\scripts\models\model_native.mlp)";
+				this->trainingTask.get().save(this->neuralPath);
+				this->neural = std::make_unique<Neural>(this->neuralPath);
 			}
-			else if (this->control == Control::REPLAY)
+		}
+
+		if (control == Control::MANUAL or control == Control::AUTO or control == Control::NEURAL or control == Control::FUZZY or control == Control::EVOLUTION or control == Control::DAGGER)
+		{
+			// Cars that reached the end are marked here and retired below, out of the parallel loop since it changes the world
+#pragma omp parallel for
+			for (auto k{ 0 }; k < this->active.size(); k++)
 			{
-				oss << "REPLAY";
+				const auto n{ this->active[k] };
+				if (this->mazes[n].isOnEnd(this->cars[n].position()))
+				{
+					this->active[k] = ~n;
+				}
+				else
+				{
+					this->cars[n].step();
+					this->mazes[n].step();
+				}
 			}
-			oss << '\n';
 
-			oss << "[F3] Data = ";
-			if (this->data == Data::IDLE)
+			for (const auto n : this->active)
 			{
-				oss << "IDLE";
+				if (n < 0)
+				{
+					this->cars[~n].finish();
+					this->mazes[~n].finish();
+				}
 			}
-			else if (this->data == Data::GENERATING)
+			this->active.erase(std::remove_if(this->active.begin(), this->active.end(), [](int n) { return n < 0; }), this->active.end());
+			this->done = static_cast<int>(this->cars.size() - this->active.size());
+		}
+
+		{
+			const auto scope{ Profiler::Scope{ Profiler::Phase::WORLD } };
+			Quality::step(world, this->quality());
+		}
+
+		if (this->done == this->cars.size())
+		{
+			if (this->control == Control::DAGGER)
 			{
-				oss << "GENERATING";
+				this->reset();
 			}
-			else if (this->data == Data::SAVING)
+			else if (this->current < this->generations)
 			{
-				oss << "SAVING";
+				++this->current;
+				this->reset();
 			}
-			else if (this->data == Data::DONE)
+			else
 			{
-				oss << "DONE";
+				this->control = Control::MANUAL;
+				
+				if (this->data == Data::GENERATING)
+				{
+					this->generationTask = this->generateCSV();
+					this->data = Data::SAVING;
+				}
 			}
-			oss << '\n';
+		}
+	}
 
-			oss << "[F4] Mode = ";
-			if (this->mode == Mode::STOPPED)
-			{
-				oss << "STOPPED";
-			}
-			else if (this->mode == Mode::PLAYING)
-			{
-				oss << "PLAYING";
-			}
-			oss << '\n';
+	// Sensors are refreshed for every car still driving, visible or not, since the controllers read them
+	if (control == Control::MANUAL or control == Control::NEURAL or control == Control::FUZZY or control == Control::EVOLUTION or control == Control::DAGGER)
+	{
+		for (const auto n : this->active)
+		{
+			this->cars[n].sense();
+		}
+	}
+}
 
-			static auto count{ 0 };
-			static auto linearVelocity{ 0.0f };
-			static auto angularVelocity{ 0.0f };
-			if (count == 10)
-			{
-				count = 0;
+auto Simulation::publish() -> void
+{
+	const auto scope{ Profiler::Scope{ Profiler::Phase::PUBLISH } };
 
-				if (this->cars.size() > 0)
-				{
-					linearVelocity = this->cars[0].linearVelocity();
-					angularVelocity = this->cars[0].angularVelocity();
-				}
+	auto& snapshot{ this->snapshots.back() };
+
+	snapshot.statics.clear();
+	snapshot.paths.clear();
+
+	if (control == Control::AUTO)
+	{
+		snapshot.bodies.clear();
+		snapshot.paths.resize(this->followers.size());
+		for (auto n{ 0 }; n < this->followers.size(); ++n)
+		{
+			snapshot.paths[n].bounds = this->mazes[n].bounds();
+			this->followers[n].snapshot(snapshot.paths[n]);
+		}
+	}
+	else if (control == Control::MANUAL or control == Control::NEURAL or control == Control::FUZZY or control == Control::EVOLUTION or control == Control::DAGGER)
+	{
+		snapshot.statics.resize(this->mazes.size());
+		for (auto n{ 0 }; n < this->mazes.size(); n++)
+		{
+			this->mazes[n].snapshot(snapshot.statics[n]);
+		}
+
+		snapshot.bodies.resize(this->cars.size());
+		for (auto n{ 0 }; n < this->cars.size(); n++)
+		{
+			snapshot.bodies[n].bounds = this->mazes[n].bounds();
+			this->cars[n].snapshot(snapshot.bodies[n]);
+		}
+	}
+	else if (control == Control::REPLAY)
+	{
+		snapshot.statics.resize(this->replays.size());
+		snapshot.bodies.resize(this->replays.size());
+		for (auto n{ 0 }; n < this->replays.size(); n++)
+		{
+			this->replays[n]->snapshot(snapshot.statics[n], snapshot.bodies[n]);
+		}
+	}
+
+	auto oss{ std::ostringstream{} };
+	//const auto distances{ this->cars.front().distances() };
+	//oss << "front = " << distances.at(0) << " m \n"
+	//    << "left = " << distances.at(+90) << " m \n"
+	//    << "right = " << distances.at(-90) << " m \n"
+	//    << "move = " << (move > 0 ? "+" : move < 0 ? "-" : "o") << " \n"
+	//    << "rotate = " << (rotate > 0 ? "+" : rotate < 0 ? "-" : "o") << " \n"
+	//    << "collided = " << this->cars.front().collided() << " \n";
+
+	oss << "[F1] Reset" << '\n';
+
+	oss << "[F2] Control = ";
+	if (this->control == Control::MANUAL)
+	{
+		oss << "MANUAL";
+	}
+	else if (this->control == Control::AUTO)
+	{
+		oss << "AUTO";
+	}
+	else if (this->control == Control::NEURAL)
+	{
+		oss << "NEURAL";
+	}
+	else if (this->control == Control::FUZZY)
+	{
+		oss << "FUZZY";
+	}
+	else if (this->control == Control::EVOLUTION)
+	{
+		oss << "EVOLUTION";
+	}
+	else if (this->control == Control::DAGGER)
+	{
+		oss << "DAGGER";
+	}
+	else if (this->control == Control::REPLAY)
+	{
+		oss << "REPLAY";
+	}
+	oss << '\n';
+
+	oss << "[F3] Data = ";
+	if (this->data == Data::IDLE)
+	{
+		oss << "IDLE";
+	}
+	else if (this->data == Data::GENERATING)
+	{
+		oss << "GENERATING";
+	}
+	else if (this->data == Data::SAVING)
+	{
+		oss << "SAVING";
+	}
+	else if (this->data == Data::TRAINING)
+	{
+		oss << "TRAINING";
+	}
+	else if (this->data == Data::DONE)
+	{
+		oss << "DONE";
+	}
+	oss << '\n';
+
+	oss << "[F4] Mode = ";
+	if (this->mode == Mode::STOPPED)
+	{
+		oss << "STOPPED";
+	}
+	else if (this->mode == Mode::PLAYING)
+	{
+		oss << "PLAYING";
+	}
+	oss << '\n';
+
+	oss << "[F5] Trace = " << (Profiler::isTracing() ? "RECORDING" : "OFF") << '\n';
+	oss << "[F6] Layout = " << Maze::layoutNames[static_cast<int>(this->layout)] << '\n';
+	oss << "[F7] Generator = " << Maze::generatorNames[static_cast<int>(this->generator)] << '\n';
+	oss << "physics = " << this->quality().name << '\n';
+
+	static auto count{ 0 };
+	static auto linearVelocity{ 0.0f };
+	static auto angularVelocity{ 0.0f };
+	if (count == 10)
+	{
+		count = 0;
+
+		if (this->cars.size() > 0)
+		{
+			linearVelocity = this->cars[0].linearVelocity();
+			angularVelocity = this->cars[0].angularVelocity();
+		}
+	}
+	count++;
+
+	oss << "generation = " << this->current << " / " << this->generations << '\n';
+	oss << "done = " << this->done << " / " << this->quantity << '\n';
+	oss << "linear velocity = " << linearVelocity << '\n';
+	oss << "angular velocity = " << angularVelocity << '\n';
+
+	if (not this->evolutionStatus.empty())
+	{
+		oss << this->evolutionStatus << '\n';
+	}
+
+	if (this->control == Control::DAGGER)
+	{
+		oss << "dagger = " << this->rounds << " (beta " << this->beta << ", samples " << this->daggerFeatures.size() << ")" << '\n';
+	}
+
+	// Timings cover the last second, from every thread
+	if (++this->profileTicks * Window::tickStep >= 1000)
+	{
+		auto profile{ std::ostringstream{} };
+		Profiler::print(profile);
+		this->profile = profile.str();
+		this->profileTicks = 0;
+		Profiler::reset();
+	}
+	oss << this->profile;
+
+	snapshot.infos = oss.str();
+
+	this->snapshots.publish();
+}
+
+auto Simulation::render(GPU_Target* target, const Window::View& view) -> void
+{
+	const auto scope{ Profiler::Scope{ Profiler::Phase::RENDER } };
+
+	const auto& snapshot{ this->snapshots.front() };
+	this->shown = &snapshot;
+
+	// Dynamic geometry is gathered into one list and submitted once per frame
+	Draw::clear(this->drawList);
+	GPU_SetLineThickness(Draw::lineThickness);
+
+	// Everything belonging to an off-screen maze is culled, fills and beams are dropped when zoomed out
+	const auto detailed{ view.isDetailed() };
+
+	for (const auto& path : snapshot.paths)
+	{
+		if (not view.contains(path.bounds))
+		{
+			continue;
+		}
+		for (auto n{ 1 }; n < path.points.size(); ++n)
+		{
+			Draw::append(this->drawList, path.points[n - 1], path.points[n], Snapshot::pathColor);
+		}
+	}
+
+	for (const auto& body : snapshot.bodies)
+	{
+		if (not view.contains(body.bounds))
+		{
+			continue;
+		}
+		Draw::append(this->drawList, *body.shape, body.transform, detailed);
+		if (detailed)
+		{
+			for (const auto& [start, end] : body.beams)
+			{
+				Draw::append(this->drawList, start, end, Snapshot::beamColor);
 			}
-			count++;
+		}
+	}
 
-			oss << "generation = " << this->current << " / " << this->generations << '\n';
-			oss << "done = " << this->done << " / " << this->quantity << '\n';
-			oss << "linear velocity = " << linearVelocity << '\n';
-			oss << "angular velocity = " << angularVelocity << '\n';
-		});
+	Draw::draw(target, this->drawList, detailed);
 
-	window.process();
+	for (const auto& item : snapshot.statics)
+	{
+		if (not view.contains(item.bounds))
+		{
+			continue;
+		}
+		Draw::draw(target, *item.mesh, detailed);
+	}
 }
 
 auto Simulation::createGround(b2World* world) -> b2Body*
 {
 	b2BodyDef bd{};
 	bd.position = b2Vec2{ 0.0f, 0.0f };
-	bd.userData = const_cast<char*>("ground");
+	bd.userData = Fixture::tag(Fixture::Kind::GROUND);
 
 	auto ground{ world->CreateBody(&bd) };
 
@@ -488,7 +839,7 @@ auto Simulation::createGround(b2World* world) -> b2Body*
 	fd.restitution = 0.4f;
 	fd.filter.categoryBits = 0x0000;
 	fd.filter.maskBits = 0x0003;
-	fd.userData = const_cast<char*>("wall");
+	fd.userData = Fixture::tag(Fixture::Kind::GROUND);
 
 	// Left vertical
 	shape.SetTwoSided(b2Vec2{ -realWidth, -realHeight }, b2Vec2{ -realWidth, realHeight });
@@ -509,34 +860,36 @@ auto Simulation::createGround(b2World* world) -> b2Body*
 	return ground;
 }
 
-auto Simulation::inputs(const Car& car) -> std::vector<float>
+auto Simulation::quality() const -> const Quality::Profile&
 {
-	auto inputs{ std::vector<float>{} };
-
-	const auto distances{ car.distances() };
-	for (auto [angle, distance] : distances)
+	if (this->control == Control::REPLAY)
+	{
+		return Quality::precise;
+	}
+	// Only once --evaluate has recorded the follower keeping its success rate on fast
+	if (this->control == Control::AUTO and this->data == Data::GENERATING and this->fastChecked)
 	{
-		inputs.emplace_back(distance);
+		return Quality::fast;
 	}
+	return Quality::standard;
+}
 
-	//const auto color{ static_cast<int>(car.color()) };
-	//{
-	//	inputs.emplace_back(color);
-	//}
+auto Simulation::grid(int quantity) -> std::pair<int, int>
+{
+	if (quantity <= 0)
+	{
+		return { 0, 0 };
+	}
 
-	//const auto giroscope{ car.giroscope() };
-	//for (auto& value : giroscope)
-	//{
-	//    inputs.emplace_back(value);
-	//}
-	//
-	//const auto acelerometer{ car.acelerometer() };
-	//for (auto& value : acelerometer)
-	//{
-	//    inputs.emplace_back(value);
-	//}
+	auto squareHeight{ static_cast<int>(std::sqrt(quantity)) };
+	auto squareWidth{ quantity / squareHeight };
+	while (squareHeight * squareWidth != quantity)
+	{
+		--squareHeight;
+		squareWidth = quantity / squareHeight;
+	}
 
-	return inputs;
+	return { squareHeight, squareWidth };
 }
 
 auto Simulation::generateCSV() -> std::future<void>
@@ -562,4 +915,25 @@ auto Simulation::generateCSV() -> std::future<void>
 				}
 			}
 		});
+}
+
+auto Simulation::train(std::vector<std::vector<float>> features, std::vector<std::vector<int>> labels) -> std::future<Network>
+{
+	return std::async(std::launch::async, [features = std::move(features), labels = std::move(labels)]
+		{
+			auto mt{ std::mt19937{ std::random_device{}() } };
+			auto network{ Network{ { 18, 48, 48, 48, 5 }, mt } };
+
+			const auto history{ Trainer{ network }.train(features, labels) };
+			for (auto n{ 0 }; n < history.size(); ++n)
+			{
+				std::cout << "epoch = " << n + 1
+					<< " | loss = " << history[n].loss
+					<< " | accuracy = " << history[n].accuracy
+					<< " | validation loss = " << history[n].validationLoss
+					<< " | validation accuracy = " << history[n].validationAccuracy << std::endl;
+			}
+
+			return network;
+		});
 }
\ No newline at end of file
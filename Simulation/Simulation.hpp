@@ -6,14 +6,22 @@
 #include <memory>
 #include <filesystem>
 #include <fstream>
+#include <array>
+#include <atomic>
+#include <mutex>
 
 #include "..\Neural.hpp"
+#include "..\Trainer.hpp"
 #include "..\Fuzzy.hpp"
 #include "..\Replay.hpp"
+#include "..\TripleBuffer.hpp"
 #include "Window.hpp"
 #include "Maze.hpp"
 #include "Car.hpp"
 #include "Follower.hpp"
+#include "Evolution.hpp"
+#include "Snapshot.hpp"
+#include "Quality.hpp"
 
 enum class Mode 
 {
@@ -27,6 +35,8 @@ enum class Control
     AUTO,
     NEURAL,
     FUZZY,
+    EVOLUTION,
+    DAGGER,
     REPLAY
 };
 
@@ -35,6 +45,7 @@ enum class Data
     IDLE = 0,
     GENERATING,
     SAVING,
+    TRAINING,
     DONE
 };
 
@@ -47,30 +58,75 @@ public:
     static constexpr float realHeight{ 5 };
 
 private:
+    auto run() -> void;
+    auto input(const uint8_t* state) -> void;
+    auto tick() -> void;
+    auto publish() -> void;
+    auto render(GPU_Target* target, const Window::View& view) -> void;
     auto reset() -> void;
+    auto quality() const -> const Quality::Profile&;
     auto generateCSV()->std::future<void>;
+    auto train(std::vector<std::vector<float>> features, std::vector<std::vector<int>> labels)->std::future<Network>;
 
     static auto createGround(b2World* world)->b2Body*;
-    static auto inputs(const Car& car) ->std::vector<float>;
+    static auto grid(int quantity)->std::pair<int, int>;
 
     Window window{ };
 
     const b2Vec2 gravity{ 0.0, 0.0 };
     b2World world{ gravity };
     b2Body* ground{ nullptr };
+    b2World replayWorld{ gravity };
+    b2Body* replayGround{ nullptr };
 
+    bool fastChecked{ false }; // Quality::isChecked, read on every reset
+    std::string neuralPath{ R"(C:\Users\Giovanni\Desktop\auto2\scripts\models\model_simulation_18s_20x_48x48x48)" };
     std::unique_ptr<Neural> neural{};
     std::unique_ptr<Fuzzy> fuzzy{};
-    std::unique_ptr<Replay> replay{};
+    std::unique_ptr<Noise> noise{};
+    std::unique_ptr<Evolution> evolution{};
+    std::unique_ptr<Network> champion{};
+    std::future<void> evolutionTask{};
+    std::string evolutionStatus{};
+    std::unique_ptr<Network> learner{};
+    std::future<Network> daggerTask{}; // apart from trainingTask, which F3 saving owns
+    std::future<Network> trainingTask{};
+    std::mt19937 mt{ std::random_device{}() };
+    float beta{ 1.0f };
+    int rounds{ 0 };
+    size_t trained{ 0 };
+    std::vector<std::vector<float>> daggerFeatures{}; // aggregated apart from features, which F3 saves and clears
+    std::vector<std::vector<int>> daggerLabels{};
+
+    static constexpr size_t daggerSamples{ 2000 };
+    static constexpr Car::Dynamics dynamics{ Car::Dynamics::DYNAMIC }; // DIRECT only once --divergence direct matches the joints
+    Maze::Layout layout{ Maze::Layout::FIXED }; // F6, taken by the next reset
+    Maze::Generator generator{ Maze::Generator::BACKTRACKER }; // F7, likewise
+    std::vector<std::unique_ptr<Replay>> replays{};
     std::vector<Car> cars{ };
     std::vector<Maze> mazes{ };
     std::vector<Follower> followers{ };
+
+    // Simulation thread writes, render thread reads
+    std::thread simulationThread{};
+    std::atomic<bool> running{ false };
+    TripleBuffer<Snapshot> snapshots{};
+    std::mutex keyboardMutex{};
+    std::array<uint8_t, SDL_NUM_SCANCODES> keyboard{};
+
+    // Render thread only
+    const Snapshot* shown{ nullptr };
+    Draw::Mesh drawList{ };
+
+    std::string profile{};
+    int profileTicks{ 0 };
     
     const int generations{ 0 };
     int current{ 0 };
 
     const int quantity{ 1 };
     int done{ 0 };
+    std::vector<int> active{}; // cars still driving, finished ones are disabled and dropped from every per-car loop
     std::future<void> generationTask{};
     std::vector<std::vector<float>> features{};
     std::vector<std::vector<int>> labels{};
@@ -82,6 +138,9 @@ private:
     bool modeChanged{ false };
     bool controlChanged{ false };
     bool dataChanged{ false };
+    bool layoutChanged{ false };
+    bool generatorChanged{ false };
+    bool traceChanged{ false };
 
     Mode mode{ Mode::STOPPED };
     Control control{ Control::NEURAL };
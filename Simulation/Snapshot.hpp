@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <box2d/box2d.h>
+#include <SDL_gpu.h>
+
+#include "..\Draw.hpp"
+
+// What the render thread draws for one simulation tick, nothing in it points back into the simulation
+struct Snapshot
+{
+    // Geometry that only changes on reset, shared instead of copied
+    struct Static
+    {
+        b2AABB bounds;
+        std::shared_ptr<const Draw::Mesh> mesh;
+    };
+
+    struct Body
+    {
+        b2AABB bounds;
+        b2Transform transform;
+        std::shared_ptr<const Draw::Mesh> shape;
+        std::vector<std::pair<b2Vec2, b2Vec2>> beams;
+    };
+
+    struct Path
+    {
+        b2AABB bounds;
+        std::vector<b2Vec2> points;
+    };
+
+    std::vector<Static> statics;
+    std::vector<Body> bodies;
+    std::vector<Path> paths;
+    std::string infos;
+
+    static constexpr SDL_Color beamColor{ 0, 0, 255, 255 };
+    static constexpr SDL_Color pathColor{ 0, 255, 0, 255 };
+};
@@ -1,4 +1,8 @@
+#include <cmath>
+#include <algorithm>
+
 #include "Window.hpp"
+#include "..\Profiler.hpp"
 
 auto Window::init(float realWidth, float realHeight) -> void
 {
@@ -20,6 +24,8 @@ auto Window::process() -> void
 
     while (not quit)
     {
+        const auto frameStart{ std::chrono::steady_clock::now() };
+
         SDL_Event e{};
         while (SDL_PollEvent(&e))
         {
@@ -27,6 +33,22 @@ auto Window::process() -> void
             {
                 this->quit = true;
             }
+            else if (e.type == SDL_MOUSEWHEEL and e.wheel.y != 0)
+            {
+                // Zoom around the cursor, keeping the world point under it in place
+                auto x{ -1 }, y{ -1 };
+                SDL_GetMouseState(&x, &y);
+
+                const auto before{ this->view().bounds };
+                const auto worldX{ before.lowerBound.x + (before.upperBound.x - before.lowerBound.x) * x / Window::screenWidth };
+                const auto worldY{ before.lowerBound.y + (before.upperBound.y - before.lowerBound.y) * y / Window::screenHeight };
+
+                this->zoom = std::clamp(this->zoom * std::pow(Window::zoomStep, static_cast<float>(e.wheel.y)), Window::minZoom, Window::maxZoom);
+
+                const auto after{ this->view().bounds };
+                this->xOffset = worldX - (after.upperBound.x - after.lowerBound.x) * x / Window::screenWidth;
+                this->yOffset = worldY - (after.upperBound.y - after.lowerBound.y) * y / Window::screenHeight;
+            }
         }
 
         {
@@ -38,6 +60,7 @@ auto Window::process() -> void
             {
                 this->xOffset = 0;
                 this->yOffset = 0;
+                this->zoom = 1.0f;
             }
 
             auto x{ -1 }, y{ -1 };
@@ -60,8 +83,9 @@ auto Window::process() -> void
                         this->dragging = false;
                     }
 
-                    this->xOffset += (this->xPos - x) / 200.0f;
-                    this->yOffset += (this->yPos - y) / 200.0f;
+                    const auto scale{ this->view().scale };
+                    this->xOffset += (this->xPos - x) / scale;
+                    this->yOffset += (this->yPos - y) / scale;
 
                     this->xPos = x;
                     this->yPos = y;
@@ -75,12 +99,13 @@ auto Window::process() -> void
             GPU_MatrixMode(target, GPU_PROJECTION);
             GPU_LoadIdentity();
             //GPU_Ortho(-this->realHeight, +this->realHeight, +this->realWidth, -this->realWidth, 0, 1); // CENTERED
-            GPU_Ortho(this->xOffset, this->xOffset + this->realHeight, this->yOffset + this->realWidth, this->yOffset, 0, 1); // CORNER
+            const auto view{ this->view() };
+            GPU_Ortho(view.bounds.lowerBound.x, view.bounds.upperBound.x, view.bounds.upperBound.y, view.bounds.lowerBound.y, 0, 1); // CORNER
 
             GPU_MatrixMode(target, GPU_MODEL);
             GPU_LoadIdentity();
 
-            this->onRenderCallback(target);
+            this->onRenderCallback(target, view);
         }
         
         {
@@ -97,7 +122,11 @@ auto Window::process() -> void
             FC_Draw(font, target, 5, 5, oss.str().data());
         }
 
-        GPU_Flip(target);
+        {
+            const auto scope{ Profiler::Scope{ Profiler::Phase::FLIP } };
+            GPU_Flip(target);
+        }
+        Profiler::record(Profiler::Phase::FRAME, frameStart, std::chrono::steady_clock::now());
 
         //const auto currentTicks{ SDL_GetTicks() };
         //targetTicks += Window::tickStep;
@@ -118,7 +147,7 @@ auto Window::onKeyboard(std::function<void(const uint8_t*)> callback) -> void
     this->onKeyboardCallback = callback;
 }
 
-auto Window::onRender(std::function<void(GPU_Target*)> callback) -> void
+auto Window::onRender(std::function<void(GPU_Target*, const View&)> callback) -> void
 {
     this->onRenderCallback = callback;
 }
@@ -131,4 +160,26 @@ auto Window::onInfos(std::function<void(std::ostringstream&)> callback) -> void
 auto Window::now() -> unsigned long long
 {
     return this->time;
-}
\ No newline at end of file
+}
+
+auto Window::view() const -> View
+{
+    const auto width{ this->realWidth / this->zoom };
+    const auto height{ this->realHeight / this->zoom };
+
+    auto view{ View{} };
+    view.bounds.lowerBound = b2Vec2{ this->xOffset, this->yOffset };
+    view.bounds.upperBound = b2Vec2{ this->xOffset + width, this->yOffset + height };
+    view.scale = Window::screenWidth / width;
+    return view;
+}
+
+auto Window::View::contains(const b2AABB& aabb) const -> bool
+{
+    return b2TestOverlap(this->bounds, aabb);
+}
+
+auto Window::View::isDetailed() const -> bool
+{
+    return this->scale >= Window::detailScale;
+}
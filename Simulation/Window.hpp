@@ -13,14 +13,25 @@
 class Window
 {
 public:
+    // Visible world rectangle and its scale in pixels per world unit
+    struct View
+    {
+        b2AABB bounds;
+        float scale;
+
+        auto contains(const b2AABB& aabb) const -> bool;
+        auto isDetailed() const -> bool;
+    };
+
     auto init(float realWidth, float realHeight) -> void;
     auto process() -> void;
 
     auto onKeyboard(std::function<void(const uint8_t*)> callback) -> void;
-    auto onRender(std::function<void(GPU_Target*)> callback) -> void;
+    auto onRender(std::function<void(GPU_Target*, const View&)> callback) -> void;
     auto onInfos(std::function<void(std::ostringstream&)> callback) -> void;
 
     auto now() -> unsigned long long;
+    auto view() const -> View;
 
     static constexpr int screenWidth{ 1000 };
     static constexpr int screenHeight{ 1000 };
@@ -32,6 +43,11 @@ public:
     static constexpr float timeStep{ 0.030f };
     static constexpr float tickStep{ 30 };
 
+    static constexpr float minZoom{ 0.1f };
+    static constexpr float maxZoom{ 10.0f };
+    static constexpr float zoomStep{ 1.1f };
+    static constexpr float detailScale{ 100.0f };
+
     static constexpr SDL_Color backgroundColor{ 0, 0, 0, 255 };
     static constexpr SDL_Color fontColor{ 0, 255, 0, 255 };
     static constexpr SDL_Color sensorColor{ 0,0,255,255 };
@@ -46,12 +62,13 @@ private:
     bool dragging{ false };
     int xPos{ 0 }, yPos{ 0 };
     float xOffset{ 0.0f }, yOffset{ 0.0f };
+    float zoom{ 1.0f };
 
     float realWidth{ NAN };
     float realHeight{ NAN };
     uint64_t time{ 0 };
 
     std::function<void(const uint8_t*)> onKeyboardCallback;
-    std::function<void(GPU_Target*)> onRenderCallback;
+    std::function<void(GPU_Target*, const View&)> onRenderCallback;
     std::function<void(std::ostringstream&)> onInfosCallback;
 };
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <cassert>
+
+#include "Trainer.hpp"
+#include "Dense.hpp"
+
+Trainer::Trainer(Network& network) : Trainer{ network, Options{} }
+{
+}
+
+Trainer::Trainer(Network& network, const Options& options)
+{
+    this->network = &network;
+    this->options = options;
+    this->first = this->zeros();
+    this->second = this->zeros();
+}
+
+auto Trainer::zeros() const -> Gradient
+{
+    auto gradient{ Gradient{} };
+    for (auto l{ 0 }; l < this->network->size(); ++l)
+    {
+        const auto& layer{ this->network->layer(l) };
+        gradient.weights.emplace_back(layer.weights.size(), 0.0f);
+        gradient.biases.emplace_back(layer.biases.size(), 0.0f);
+    }
+    return gradient;
+}
+
+auto Trainer::backward(const float* input, const int* label, Gradient& gradient, std::vector<std::vector<float>>& activations, std::vector<std::vector<float>>& deltas) const -> std::pair<float, bool>
+{
+    const auto count{ static_cast<int>(this->network->size()) };
+
+    // Forward, keeping every activation
+    for (auto l{ 0 }; l < count; ++l)
+    {
+        const auto& layer{ this->network->layer(l) };
+        const auto values{ l == 0 ? input : activations[l - 1].data() };
+
+        Dense::forward(layer.weights.data(), layer.biases.data(), values, activations[l].data(), layer.inputs, layer.outputs);
+        Network::activate(layer.activation, activations[l].data(), layer.outputs);
+    }
+
+    // Softmax with cross-entropy (or linear with squared error) gives output - label as the output delta
+    const auto& output{ activations.back() };
+    auto loss{ 0.0f };
+    for (auto o{ 0 }; o < output.size(); ++o)
+    {
+        deltas.back()[o] = output[o] - label[o];
+        if (this->network->layer(count - 1).activation == Network::Activation::SOFTMAX)
+        {
+            loss -= label[o] * std::log(std::max(output[o], 1e-7f));
+        }
+        else
+        {
+            loss += 0.5f * deltas.back()[o] * deltas.back()[o];
+        }
+    }
+
+    const auto predicted{ std::max_element(output.begin(), output.end()) - output.begin() };
+    const auto correct{ label[predicted] == 1 };
+
+    // Backward
+    for (auto l{ count - 1 }; l >= 0; --l)
+    {
+        const auto& layer{ this->network->layer(l) };
+        const auto values{ l == 0 ? input : activations[l - 1].data() };
+        const auto& delta{ deltas[l] };
+
+        for (auto o{ 0 }; o < layer.outputs; ++o)
+        {
+            Dense::axpy(delta[o], values, gradient.weights[l].data() + o * layer.inputs, layer.inputs);
+            gradient.biases[l][o] += delta[o];
+        }
+
+        if (l > 0)
+        {
+            auto& previous{ deltas[l - 1] };
+            std::fill(previous.begin(), previous.end(), 0.0f);
+            for (auto o{ 0 }; o < layer.outputs; ++o)
+            {
+                Dense::axpy(delta[o], layer.weights.data() + o * layer.inputs, previous.data(), layer.inputs);
+            }
+
+            if (this->network->layer(l - 1).activation == Network::Activation::RELU)
+            {
+                for (auto i{ 0 }; i < previous.size(); ++i)
+                {
+                    previous[i] = activations[l - 1][i] > 0.0f ? previous[i] : 0.0f;
+                }
+            }
+        }
+    }
+
+    return { loss, correct };
+}
+
+auto Trainer::apply(const Gradient& gradient, int count) -> void
+{
+    ++this->steps;
+
+    const auto scale{ 1.0f / count };
+    const auto rate{ this->options.learningRate };
+    const auto beta1{ this->options.beta1 };
+    const auto beta2{ this->options.beta2 };
+    const auto correction1{ 1.0f - std::pow(beta1, static_cast<float>(this->steps)) };
+    const auto correction2{ 1.0f - std::pow(beta2, static_cast<float>(this->steps)) };
+
+    const auto update{ [&](std::vector<float>& parameters, const std::vector<float>& gradients, std::vector<float>& first, std::vector<float>& second)
+    {
+        for (auto n{ 0 }; n < parameters.size(); ++n)
+        {
+            const auto g{ gradients[n] * scale };
+            if (this->options.optimizer == Optimizer::ADAM)
+            {
+                first[n] = beta1 * first[n] + (1.0f - beta1) * g;
+                second[n] = beta2 * second[n] + (1.0f - beta2) * g * g;
+                parameters[n] -= rate * (first[n] / correction1) / (std::sqrt(second[n] / correction2) + 1e-7f);
+            }
+            else
+            {
+                first[n] = this->options.momentum * first[n] - rate * g;
+                parameters[n] += first[n];
+            }
+        }
+    } };
+
+    for (auto l{ 0 }; l < this->network->size(); ++l)
+    {
+        auto& layer{ this->network->layer(l) };
+        update(layer.weights, gradient.weights[l], this->first.weights[l], this->second.weights[l]);
+        update(layer.biases, gradient.biases[l], this->first.biases[l], this->second.biases[l]);
+    }
+}
+
+auto Trainer::evaluate(const std::vector<std::vector<float>>& features, const std::vector<std::vector<int>>& labels, const std::vector<int>& indices) const -> std::pair<float, float>
+{
+    if (indices.empty())
+    {
+        return { 0.0f, 0.0f };
+    }
+
+    auto loss{ 0.0 };
+    auto correct{ 0 };
+
+#pragma omp parallel for reduction(+:loss, correct)
+    for (auto n{ 0 }; n < indices.size(); ++n)
+    {
+        const auto outputs{ this->network->inference(features[indices[n]]) };
+        const auto& label{ labels[indices[n]] };
+
+        const auto predicted{ std::max_element(outputs.begin(), outputs.end()) - outputs.begin() };
+        correct += (label[predicted] == 1);
+
+        for (auto o{ 0 }; o < outputs.size(); ++o)
+        {
+            loss -= label[o] * std::log(std::max(outputs[o], 1e-7f));
+        }
+    }
+
+    return { static_cast<float>(loss / indices.size()), static_cast<float>(correct) / indices.size() };
+}
+
+auto Trainer::train(const std::vector<std::vector<float>>& features, const std::vector<std::vector<int>>& labels) -> std::vector<Epoch>
+{
+    assert(features.size() == labels.size());
+
+    auto history{ std::vector<Epoch>{} };
+    if (features.empty())
+    {
+        return history;
+    }
+
+    auto indices{ std::vector<int>(features.size()) };
+    std::iota(indices.begin(), indices.end(), 0);
+    std::shuffle(indices.begin(), indices.end(), mt);
+
+    const auto split{ static_cast<int>(indices.size() * (1.0f - this->options.validation)) };
+    auto training{ std::vector<int>(indices.begin(), indices.begin() + split) };
+    const auto validation{ std::vector<int>(indices.begin() + split, indices.end()) };
+
+    // Each thread accumulates the gradient of its slice of the batch, the slices are summed before the update
+    const auto threads{ static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) };
+    auto gradients{ std::vector<Gradient>(threads, this->zeros()) };
+    auto activations{ std::vector<std::vector<std::vector<float>>>(threads) };
+    auto deltas{ std::vector<std::vector<std::vector<float>>>(threads) };
+    for (auto t{ 0 }; t < threads; ++t)
+    {
+        for (auto l{ 0 }; l < this->network->size(); ++l)
+        {
+            activations[t].emplace_back(this->network->layer(l).outputs, 0.0f);
+            deltas[t].emplace_back(this->network->layer(l).outputs, 0.0f);
+        }
+    }
+
+    for (auto epoch{ 0 }; epoch < this->options.epochs; ++epoch)
+    {
+        std::shuffle(training.begin(), training.end(), mt);
+
+        auto loss{ 0.0 };
+        auto correct{ 0 };
+
+        for (auto begin{ 0 }; begin < training.size(); begin += this->options.batchSize)
+        {
+            const auto end{ std::min(begin + this->options.batchSize, static_cast<int>(training.size())) };
+
+#pragma omp parallel for reduction(+:loss, correct)
+            for (auto t{ 0 }; t < threads; ++t)
+            {
+                auto& gradient{ gradients[t] };
+                for (auto& weights : gradient.weights)
+                {
+                    std::fill(weights.begin(), weights.end(), 0.0f);
+                }
+                for (auto& biases : gradient.biases)
+                {
+                    std::fill(biases.begin(), biases.end(), 0.0f);
+                }
+
+                const auto first{ begin + (end - begin) * t / threads };
+                const auto last{ begin + (end - begin) * (t + 1) / threads };
+                for (auto n{ first }; n < last; ++n)
+                {
+                    const auto sample{ training[n] };
+                    const auto [sampleLoss, sampleCorrect] { this->backward(features[sample].data(), labels[sample].data(), gradient, activations[t], deltas[t]) };
+                    loss += sampleLoss;
+                    correct += sampleCorrect;
+                }
+            }
+
+            for (auto t{ 1 }; t < threads; ++t)
+            {
+                for (auto l{ 0 }; l < this->network->size(); ++l)
+                {
+                    Dense::axpy(1.0f, gradients[t].weights[l].data(), gradients.front().weights[l].data(), gradients[t].weights[l].size());
+                    Dense::axpy(1.0f, gradients[t].biases[l].data(), gradients.front().biases[l].data(), gradients[t].biases[l].size());
+                }
+            }
+
+            this->apply(gradients.front(), end - begin);
+        }
+
+        const auto [validationLoss, validationAccuracy] { this->evaluate(features, labels, validation) };
+        history.emplace_back(Epoch{
+            static_cast<float>(loss / std::max<size_t>(training.size(), 1)),
+            static_cast<float>(correct) / std::max<size_t>(training.size(), 1),
+            validationLoss,
+            validationAccuracy
+        });
+    }
+
+    return history;
+}
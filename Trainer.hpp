@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <random>
+
+#include "Network.hpp"
+
+class Trainer
+{
+public:
+    enum class Optimizer
+    {
+        SGD = 0,
+        ADAM
+    };
+
+    struct Options
+    {
+        Optimizer optimizer{ Optimizer::ADAM };
+        float learningRate{ 0.001f };
+        float momentum{ 0.8f };
+        float beta1{ 0.9f };
+        float beta2{ 0.999f };
+        int batchSize{ 256 };
+        int epochs{ 50 };
+        float validation{ 0.2f };
+    };
+
+    struct Epoch
+    {
+        float loss;
+        float accuracy;
+        float validationLoss;
+        float validationAccuracy;
+    };
+
+    Trainer(Network& network);
+    Trainer(Network& network, const Options& options);
+
+    auto train(const std::vector<std::vector<float>>& features, const std::vector<std::vector<int>>& labels) -> std::vector<Epoch>;
+
+private:
+    // One buffer per parameter of the network, laid out like Network::Layer
+    struct Gradient
+    {
+        std::vector<std::vector<float>> weights;
+        std::vector<std::vector<float>> biases;
+    };
+
+    auto zeros() const -> Gradient;
+    auto backward(const float* input, const int* label, Gradient& gradient, std::vector<std::vector<float>>& activations, std::vector<std::vector<float>>& deltas) const -> std::pair<float, bool>;
+    auto evaluate(const std::vector<std::vector<float>>& features, const std::vector<std::vector<int>>& labels, const std::vector<int>& indices) const -> std::pair<float, float>;
+    auto apply(const Gradient& gradient, int count) -> void;
+
+    Network* network{ nullptr };
+    Options options{};
+    std::mt19937 mt{ std::random_device{}() };
+
+    Gradient first{};
+    Gradient second{};
+    int steps{ 0 };
+};
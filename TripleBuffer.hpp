@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Lock-free hand-off between one writer and one reader, each side owning a slot and swapping through the middle one.
+// The writer never waits for the reader and the reader always gets the latest complete value.
+template<typename T>
+class TripleBuffer
+{
+public:
+    // Slot owned by the writer, its previous contents are stale and must be fully overwritten
+    auto back() -> T&
+    {
+        return this->slots[this->backIndex];
+    }
+
+    auto publish() -> void
+    {
+        this->backIndex = this->middle.exchange(this->backIndex | TripleBuffer::dirty) & TripleBuffer::mask;
+    }
+
+    // Latest published slot, stays untouched by the writer until the next call
+    auto front() -> const T&
+    {
+        if (this->middle.load() & TripleBuffer::dirty)
+        {
+            this->frontIndex = this->middle.exchange(this->frontIndex) & TripleBuffer::mask;
+        }
+        return this->slots[this->frontIndex];
+    }
+
+private:
+    static constexpr int dirty{ 0b100 };
+    static constexpr int mask{ 0b011 };
+
+    std::array<T, 3> slots{};
+    int backIndex{ 0 };
+    int frontIndex{ 1 };
+    std::atomic<int> middle{ 2 };
+};
@@ -6,15 +6,234 @@
 #include <thread>
 #include <chrono>
 #include <cstring>
+#include <string>
+#include <fstream>
+#include <algorithm>
 
 #include "Simulation/Simulation.hpp"
+#include "Divergence.hpp"
+#include "Noise.hpp"
+#include "Simulation/Evolution.hpp"
+#include "Simulation/Episode.hpp"
+#include "Simulation/Evaluation.hpp"
+#include "Raster.hpp"
+#include "Recorder.hpp"
+#include "Profiler.hpp"
 
 Simulation simulation{};
 
+// Trailing argument of the headless modes, DYNAMIC unless named
+static auto dynamics(int argc, char* args[], int index) -> Car::Dynamics
+{
+    if (argc > index and std::string{ args[index] } == "kinematic")
+    {
+        return Car::Dynamics::KINEMATIC;
+    }
+    if (argc > index and std::string{ args[index] } == "direct")
+    {
+        return Car::Dynamics::DIRECT;
+    }
+    return Car::Dynamics::DYNAMIC;
+}
+
+// Maze generator of the headless modes by name, the recursive backtracker unless named
+static auto generator(int argc, char* args[], int index) -> Maze::Generator
+{
+    for (auto n{ 0 }; argc > index and n < Maze::generatorNames.size(); ++n)
+    {
+        if (std::string{ args[index] } == Maze::generatorNames[n])
+        {
+            return static_cast<Maze::Generator>(n);
+        }
+    }
+    return Maze::Generator::BACKTRACKER;
+}
+
 int main(int argc, char* args[])
 {
     _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
-    
+
+    if (argc > 1 and std::string{ args[1] } == "--divergence")
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+
+        const auto folderPath{ argc > 2 ? args[2] : R"(C:\Users\Giovanni\Desktop\auto2\scripts)" };
+        // 'direct' replays without the friction joints, to compare against a run with them before switching the simulator over
+        const auto dynamics{ ::dynamics(argc, args, 3) };
+        const auto reports{ Divergence::analyze(Replay::captures(folderPath), dynamics != Car::Dynamics::DIRECT) };
+        Divergence::print(reports);
+        Divergence::save(reports, dynamics == Car::Dynamics::DIRECT ? R"(scripts\divergence-direct.csv)" : R"(scripts\divergence.csv)");
+
+        const auto elapsed{ std::chrono::duration<float>{ std::chrono::steady_clock::now() - start } };
+        std::cout << "elapsed = " << elapsed.count() << " s" << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    if (argc > 1 and std::string{ args[1] } == "--noise")
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+
+        const auto folderPath{ argc > 2 ? args[2] : R"(C:\Users\Giovanni\Desktop\auto2\scripts)" };
+        const auto filePath{ argc > 3 ? args[3] : R"(C:\Users\Giovanni\Desktop\auto2\scripts\noise.csv)" };
+        const auto reports{ Divergence::analyze(Replay::captures(folderPath)) };
+        Noise::fit(reports).save(filePath);
+
+        const auto elapsed{ std::chrono::duration<float>{ std::chrono::steady_clock::now() - start } };
+        std::cout << "noise profile = " << filePath << '\n'
+            << "elapsed = " << elapsed.count() << " s" << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    if (argc > 1 and std::string{ args[1] } == "--evolve")
+    {
+        const auto generations{ argc > 2 ? std::atoi(args[2]) : 100 };
+        const auto dynamics{ ::dynamics(argc, args, 3) };
+        const auto generator{ ::generator(argc, args, 4) };
+
+        auto noise{ std::unique_ptr<Noise>{} };
+        if (std::filesystem::exists(R"(C:\Users\Giovanni\Desktop\auto2\scripts\noise.csv)"))
+        {
+            noise = std::make_unique<Noise>(R"(C:\Users\Giovanni\Desktop\auto2\scripts\noise.csv)");
+        }
+
+        // Box2D step breakdown of every episode in the generation, one row each
+        auto physics{ std::ofstream{ R"(C:\Users\Giovanni\Desktop\auto2\scripts\physics.csv)" } };
+        Profiler::header(physics);
+        const auto start{ std::chrono::steady_clock::now() };
+
+        auto evolution{ Evolution{ { 18, 48, 48, 48, 5 }, 64, noise.get(), dynamics, Maze::Layout::GENERATED, generator } };
+        for (auto n{ 0 }; n < generations; ++n)
+        {
+            Profiler::reset();
+            evolution.generation();
+            Profiler::row(physics, std::chrono::duration<double>{ std::chrono::steady_clock::now() - start }.count());
+
+            std::cout << "generation = " << evolution.generations()
+                << " | best = " << evolution.bestFitness()
+                << " | mean = " << evolution.meanFitness() << std::endl;
+        }
+        evolution.best().save(R"(C:\Users\Giovanni\Desktop\auto2\scripts\evolution.mlp)");
+
+        return EXIT_SUCCESS;
+    }
+
+    if (argc > 1 and std::string{ args[1] } == "--evaluate")
+    {
+        // Every controller over the same seeded mazes: the follower, each model in scripts/models and the fuzzy engine
+        const auto episodes{ argc > 2 ? std::atoi(args[2]) : 100 };
+        const auto seed{ argc > 3 ? static_cast<uint32_t>(std::stoul(args[3])) : uint32_t{ 42 } };
+        const auto folderPath{ std::filesystem::path{ argc > 4 ? args[4] : R"(C:\Users\Giovanni\Desktop\auto2\scripts)" } };
+        const auto dynamics{ ::dynamics(argc, args, 5) };
+        const auto generator{ ::generator(argc, args, 6) };
+
+        auto evaluation{ Evaluation{ seed, episodes, dynamics, Maze::Layout::GENERATED, generator } };
+
+        const auto report{ [](const Evaluation::Result& result)
+        {
+            std::cout << result.name
+                << " | success = " << result.successes << " / " << result.episodes
+                << " | ticks = " << result.meanTicks
+                << " | collisions = " << result.meanCollisions
+                << " | progress = " << result.meanProgress
+                << " | decision = " << result.decisionCost << " ns"
+                << " | elapsed = " << result.elapsed << " s" << std::endl;
+        } };
+
+        // The simulator generates the follower's training data on the fast physics profile only once this check has passed
+        const auto follower{ Evaluation::Controller{ "AUTO", [](Episode& episode) { return episode.expert(); }, true } };
+        const auto standard{ evaluation.run(follower) };
+        report(standard);
+        const auto fast{ evaluation.run(follower, Quality::fast) };
+        report(fast);
+
+        const auto within{ Quality::check(episodes, standard.successes, fast.successes) };
+        const auto loss{ static_cast<float>(standard.successes - fast.successes) / std::max(episodes, 1) };
+        if (standard.successes == 0)
+        {
+            std::cout << "fast physics = unmeasured (the follower never finished on standard)" << std::endl;
+        }
+        else
+        {
+            std::cout << "fast physics = " << (within ? "within" : "OUTSIDE") << " tolerance (success loss " << loss << ")" << std::endl;
+        }
+
+        const auto modelsPath{ std::filesystem::path{ R"(C:\Users\Giovanni\Desktop\auto2\scripts\models)" } };
+        if (std::filesystem::is_directory(modelsPath))
+        {
+            for (const auto& entry : std::filesystem::directory_iterator{ modelsPath })
+            {
+                const auto neural{ Neural{ entry.path().string() } };
+                report(evaluation.run({ "NEURAL/" + entry.path().filename().string(), [&](Episode& episode) { return Car::decide(neural.inference(episode.inputs())); }, true }));
+            }
+        }
+
+        // The fuzzylite engine keeps its state in the variables, so it drives one episode at a time
+        const auto fuzzyPath{ std::filesystem::path{ R"(C:\Users\Giovanni\Desktop\auto2\fuzzy.fll)" } };
+        if (std::filesystem::exists(fuzzyPath))
+        {
+            const auto fuzzy{ Fuzzy{ fuzzyPath.string() } };
+            report(evaluation.run({ "FUZZY", [&](Episode& episode) { return Car::decide(fuzzy.inference(episode.inputs())); }, false }));
+        }
+
+        evaluation.save((folderPath / "evaluation.json").string());
+        evaluation.saveRuns((folderPath / "evaluation.csv").string());
+
+        return EXIT_SUCCESS;
+    }
+
+    if (argc > 2 and std::string{ args[1] } == "--record")
+    {
+        // Drives fresh episodes with a native network and captures them to Y4M, optionally keeping only the failures
+        const auto network{ Network{ args[2] } };
+        const auto episodes{ argc > 3 ? std::atoi(args[3]) : 10 };
+        const auto folderPath{ std::filesystem::path{ argc > 4 ? args[4] : R"(C:\Users\Giovanni\Desktop\auto2\scripts\captures)" } };
+        const auto onlyFailures{ argc > 5 and std::string{ args[5] } == "failures" };
+
+        std::filesystem::create_directories(folderPath);
+
+        auto physics{ std::ofstream{ (folderPath / "physics.csv").string() } };
+        Profiler::header(physics);
+        const auto start{ std::chrono::steady_clock::now() };
+
+        auto raster{ Raster{ 480, 480 } };
+        auto snapshot{ Snapshot{} };
+        for (auto n{ 0 }; n < episodes; ++n)
+        {
+            Profiler::reset();
+            const auto filePath{ (folderPath / ("episode_" + std::to_string(n) + ".y4m")).string() };
+
+            auto episode{ Episode{ nullptr, std::nullopt, Car::Dynamics::DYNAMIC, Quality::standard, Maze::Layout::GENERATED } };
+            auto bounds{ episode.bounds() };
+            bounds.lowerBound -= b2Vec2{ 0.1f, 0.1f };
+            bounds.upperBound += b2Vec2{ 0.1f, 0.1f };
+            raster.view(bounds);
+
+            {
+                auto recorder{ Recorder{ filePath, raster.width(), raster.height(), static_cast<int>(1000 / Window::tickStep) } };
+                while (not episode.isDone() and episode.ticks() < Evolution::ticks)
+                {
+                    episode.step(Car::decide(network.inference(episode.inputs())));
+
+                    episode.snapshot(snapshot);
+                    raster.clear(Window::backgroundColor);
+                    raster.draw(snapshot);
+                    recorder.push(raster.pixels());
+                }
+            }
+
+            Profiler::row(physics, std::chrono::duration<double>{ std::chrono::steady_clock::now() - start }.count());
+            std::cout << "episode = " << n << " | done = " << episode.isDone() << " | ticks = " << episode.ticks() << std::endl;
+            if (onlyFailures and episode.isDone())
+            {
+                std::filesystem::remove(filePath);
+            }
+        }
+
+        return EXIT_SUCCESS;
+    }
+
     simulation.init();
     
     return EXIT_SUCCESS;